@@ -0,0 +1,256 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file aic.cpp
+\brief Alternating Inference Chains (AIC) algorithm implementation
+
+See:
+- http://www.sudokuwiki.org/Alternating_Inference_Chains
+- http://www.sudokuwiki.org/XY_Chains
+
+A node is a (cell,candidate) pair, so there are at most 729 nodes.
+- A strong link between two nodes means that at least one of them is true:
+two cells that are the only ones holding a candidate in a row/col/block, or the two candidates of a cell having only two.
+- A weak link between two nodes means that they can not both be true:
+two candidates of the same cell, or the same candidate in two cells that see each other.
+
+If, starting from node A assumed false, we can reach node B assumed true by following a chain
+alternating strong and weak links, then A or B is true.
+So any candidate weakly linked to both A and B can be removed.
+*/
+
+#include "grid.h"
+#include "header.h"
+#include "aic.h"
+#include "algorithms.h"
+
+/// Nb of weak links of a node: the 8 other candidates of the cell, and the same candidate in the 20 peers
+const size_t NB_WEAK_LINKS = 8+20;
+
+using WeakLinksTable = std::array<std::array<uint16_t,NB_WEAK_LINKS>,NB_AIC_NODES>;
+
+//----------------------------------------------------------------------------
+/// Returns the table of potential weak links of each node (computed only once)
+/**
+This only depends on the grid geometry, a weak link actually exists only if both nodes are candidates.
+*/
+const WeakLinksTable&
+GetWeakLinksTable()
+{
+	static WeakLinksTable table = []()
+	{
+		WeakLinksTable t;
+		const auto& peers = GetPeersTable();
+		for( index_t c=0; c<81; c++ )
+			for( value_t v=1; v<10; v++ )
+			{
+				auto& links = t[ GetNodeIndex(c,v) ];
+				size_t n = 0;
+				for( value_t v2=1; v2<10; v2++ )
+					if( v2 != v )
+						links[n++] = GetNodeIndex( c, v2 );
+				for( auto p: peers[c] )
+					links[n++] = GetNodeIndex( p, v );
+			}
+		return t;
+	}();
+	return table;
+}
+//----------------------------------------------------------------------------
+/// Streams node as cell position and candidate, i.e. "B4(7)"
+void
+PrintNode( std::ostream& s, uint16_t node )
+{
+	s << GetPosFromCellIndex( node/9 ) << '(' << node%9+1 << ')';
+}
+//----------------------------------------------------------------------------
+/// Returns the storage used by Algo_AIC() on this grid, created on first use
+AicGraph&
+Grid::GetAicGraph()
+{
+	if( !_aicGraph )
+		_aicGraph.reset( new AicGraph );
+	return *_aicGraph;
+}
+//----------------------------------------------------------------------------
+void
+AicGraph::AddStrongLink( uint16_t n1, uint16_t n2 )
+{
+	auto add = [&]( uint16_t from, uint16_t to )
+	{
+		for( uint8_t i=0; i<_nbStrong[from]; i++ )
+			if( _strong[from][i] == to )                // already there (i.e.: same row AND same block)
+				return;
+		assert( _nbStrong[from] < MAX_STRONG_LINKS );
+		_strong[from][ _nbStrong[from]++ ] = to;
+	};
+	add( n1, n2 );
+	add( n2, n1 );
+}
+//----------------------------------------------------------------------------
+/// Builds the nodes and strong links from the grid content
+void
+AicGraph::Build( const Grid& g )
+{
+	_cand.reset();
+	_nbStrong.fill( 0 );
+
+	for( index_t c=0; c<81; c++ )
+	{
+		const Cell& cell = g.getCell( c );
+		for( value_t v=1; v<10; v++ )
+			if( cell.HasCandidate( v ) )
+				_cand.set( GetNodeIndex( c, v ) );
+
+		if( cell.NbCandidates() == 2 )                    // bivalue cell
+		{
+			value_t v1 = 0;
+			for( value_t v=1; v<10; v++ )
+				if( cell.HasCandidate( v ) )
+				{
+					if( v1 == 0 )
+						v1 = v;
+					else
+						AddStrongLink( GetNodeIndex( c, v1 ), GetNodeIndex( c, v ) );
+				}
+		}
+	}
+
+	for( const auto& unit: GetUnitsTable() )               // conjugate pairs
+		for( value_t v=1; v<10; v++ )
+		{
+			uint8_t nb = 0;
+			std::array<index_t,2> cells;
+			for( auto c: unit )
+				if( _cand[ GetNodeIndex( c, v ) ] )
+				{
+					if( nb < 2 )
+						cells[nb] = c;
+					nb++;
+				}
+			if( nb == 2 )
+				AddStrongLink( GetNodeIndex( cells[0], v ), GetNodeIndex( cells[1], v ) );
+		}
+}
+//----------------------------------------------------------------------------
+/// Breadth-first search of the nodes that can be reached from node \c start, assumed false
+/**
+Results are in \c _onTrue and \c _onFalse. Chains are at most \c maxDepth links long.
+*/
+void
+AicGraph::Search( uint16_t start, size_t maxDepth )
+{
+	const auto& weakLinks = GetWeakLinksTable();
+	_onTrue.reset();
+	_onFalse.reset();
+	_onFalse.set( start );
+	_frontier[0] = start;
+	size_t nbFrontier = 1;
+	bool frontierIsFalse = true;
+
+	for( size_t depth=0; depth<maxDepth && nbFrontier!=0; depth++ )
+	{
+		size_t nbNext = 0;
+		for( size_t i=0; i<nbFrontier; i++ )
+		{
+			auto n = _frontier[i];
+			if( frontierIsFalse )                       // false => strong link => true
+			{
+				for( uint8_t j=0; j<_nbStrong[n]; j++ )
+				{
+					auto n2 = _strong[n][j];
+					if( !_onTrue[n2] )
+					{
+						_onTrue.set( n2 );
+						_nextFrontier[nbNext++] = n2;
+					}
+				}
+			}
+			else                                        // true => weak link => false
+			{
+				for( auto n2: weakLinks[n] )
+					if( _cand[n2] && !_onFalse[n2] )
+					{
+						_onFalse.set( n2 );
+						_nextFrontier[nbNext++] = n2;
+					}
+			}
+		}
+		std::swap( _frontier, _nextFrontier );
+		nbFrontier = nbNext;
+		frontierIsFalse = !frontierIsFalse;
+	}
+}
+//----------------------------------------------------------------------------
+/// Alternating Inference Chains algorithm (also handles XY-chains, and single-digit chains)
+/**
+For each candidate A, we search all the nodes B such that "A or B" is true (see file header),
+and we remove the candidates that are weakly linked to A and to one of these B.
+Returns after the first A that enabled some removal.
+
+Chain length is bounded by GlobData::aicMaxDepth.
+*/
+bool
+Algo_AIC( Grid& g )
+{
+	PRINT_ALGO_START_2;
+
+	auto& graph = g.GetAicGraph();
+	graph.Build( g );
+	const auto& weakLinks = GetWeakLinksTable();
+
+	for( uint16_t a=0; a<NB_AIC_NODES; a++ )
+	{
+		if( !graph._cand[a] )
+			continue;
+		graph.Search( a, g_data.aicMaxDepth );
+
+		bool retval( false );
+		for( auto x: weakLinks[a] )        // for each candidate X weakly linked to A,
+			if( graph._cand[x] )
+				for( auto b: weakLinks[x] )   // if X is weakly linked to a B, then it can be removed
+					if( graph._onTrue[b] )
+					{
+						if( IsVerbose() )
+						{
+							std::cout << "AIC: ";
+							PrintNode( std::cout, a );
+							std::cout << " or ";
+							PrintNode( std::cout, b );
+							std::cout << " => remove ";
+							PrintNode( std::cout, x );
+							std::cout << '\n';
+						}
+						if( g.getCell( x/9 ).RemoveCandidate( x%9+1 ) )
+							retval = true;
+						break;
+					}
+		if( retval )
+			return true;
+	}
+	return false;
+}
+//----------------------------------------------------------------------------
@@ -0,0 +1,79 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file
+\brief specific header file for Alternating Inference Chains (AIC) algorithm
+*/
+
+#ifndef AIC_H_
+#define AIC_H_
+
+#include <array>
+#include <bitset>
+
+/// Nb of nodes considered by AIC: a node is a (cell,candidate) pair
+const size_t NB_AIC_NODES = 81*9;
+
+/// A set of nodes, see GetNodeIndex()
+using NodeSet = std::bitset<NB_AIC_NODES>;
+
+/// Index of a node (cell,candidate), in [0-728]
+inline
+uint16_t
+GetNodeIndex( index_t cellIdx, value_t cand )
+{
+	return cellIdx*9 + cand-1;
+}
+
+/// Max nb of strong links of a node: one per row/col/block, and one inside the cell
+const size_t MAX_STRONG_LINKS = 4;
+
+//----------------------------------------------------------------------------
+/// Links graph used by the AIC algorithm, along with the storage used by the search. See Algo_AIC()
+/**
+All the storage is allocated once per grid (see Grid::GetAicGraph()), no allocation happens during the search.
+*/
+struct AicGraph
+{
+	NodeSet _cand;                                                         ///< nodes that are candidates in the grid
+	std::array<std::array<uint16_t,MAX_STRONG_LINKS>,NB_AIC_NODES> _strong; ///< strong links of each node
+	std::array<uint8_t,NB_AIC_NODES>                              _nbStrong;
+
+	NodeSet _onTrue;                                  ///< nodes reached as "true" by the current search
+	NodeSet _onFalse;                                 ///< nodes reached as "false" by the current search
+	std::array<uint16_t,NB_AIC_NODES> _frontier;      ///< nodes reached at previous depth
+	std::array<uint16_t,NB_AIC_NODES> _nextFrontier;  ///< nodes reached at current depth
+
+	void Build( const Grid& );
+	void Search( uint16_t start, size_t maxDepth );
+
+	private:
+		void AddStrongLink( uint16_t n1, uint16_t n2 );
+};
+//----------------------------------------------------------------------------
+bool Algo_AIC( Grid& g );
+
+#endif
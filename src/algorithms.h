@@ -32,6 +32,11 @@
 
 #include "grid.h"
 #include "x_cycles.h"
+#include "aic.h"
+#include "coloring.h"
+#include "als.h"
+#include "pom.h"
+#include "forcing.h"
 
 bool Algo_PointingPairsTriples(  Grid& g );
 bool Algo_BoxReduction(          Grid& g );
@@ -40,7 +45,16 @@ bool Algo_SearchSingleMissing(   Grid& g );
 bool Algo_SearchSingleCand(      Grid& g );
 bool Algo_SearchNakedPairs(      Grid& g );
 bool Algo_SearchNakedTriples(    Grid& g );
+bool Algo_SearchNakedQuads(      Grid& g );
+bool Algo_SearchHiddenPairs(     Grid& g );
+bool Algo_SearchHiddenTriples(   Grid& g );
+bool Algo_SearchHiddenQuads(     Grid& g );
+bool Algo_X_Wing(                Grid& g );
+bool Algo_Swordfish(             Grid& g );
+bool Algo_Jellyfish(             Grid& g );
 bool Algo_XY_Wing(               Grid& g );
+bool Algo_XYZ_Wing(              Grid& g );
+bool Algo_W_Wing(                Grid& g );
 
 
 inline
@@ -52,80 +66,79 @@ GetString( EN_ALGO algo )
 		case ALG_REMOVE_CAND: return "RemoveCand"; break;
 		case ALG_SEARCH_PAIRS: return "SearchNakedPairs"; break;
 		case ALG_SEARCH_TRIPLES: return "SearchNakedTriples"; break;
+		case ALG_SEARCH_QUADS: return "SearchNakedQuads"; break;
 		case ALG_SEARCH_SINGLE_CAND: return "SearchSingleCand"; break;
 		case ALG_SEARCH_MISSING_SINGLE: return "MissingSingle"; break;
 		case ALG_POINTING_PT: return "PointingPairs/Triples"; break;
 		case ALG_BOX_RED: return "BoxReduction"; break;
+		case ALG_HIDDEN_PAIRS: return "SearchHiddenPairs"; break;
+		case ALG_HIDDEN_TRIPLES: return "SearchHiddenTriples"; break;
+		case ALG_HIDDEN_QUADS: return "SearchHiddenQuads"; break;
+		case ALG_X_WING: return "X_Wing"; break;
+		case ALG_SWORDFISH: return "Swordfish"; break;
+		case ALG_JELLYFISH: return "Jellyfish"; break;
 		case ALG_XY_WING: return "XY_Wing"; break;
+		case ALG_XYZ_WING: return "XYZ_Wing"; break;
+		case ALG_W_WING: return "W_Wing"; break;
 #ifndef BUILD_WITHOUT_UDGCD
 		case ALG_X_CYCLES: return "X_cycles"; break;
 #endif
+		case ALG_COLORING: return "Coloring"; break;
+		case ALG_MEDUSA: return "3D_Medusa"; break;
+		case ALG_ALS_XZ: return "ALS_XZ"; break;
+		case ALG_AIC: return "AIC"; break;
+		case ALG_PATTERN_OVERLAY: return "PatternOverlay"; break;
+		case ALG_FORCING: return "ForcingChains"; break;
 		default: assert(0);
 	}
 }
 
 #define PRINT_ALGO_START \
 	{ \
-		if( g_data.LogSteps > 2 ) \
+		if( LogLevel() > 2 ) \
 			std::cout << "START ALGO: " << __FUNCTION__ << ", orient=" << GetString( orient ) << '\n'; \
 	}
 
 #define PRINT_ALGO_START_2 \
 	{ \
-		if( g_data.LogSteps > 2 ) \
+		if( LogLevel() > 2 ) \
 			std::cout << "START ALGO: " << __FUNCTION__ << '\n'; \
 	}
 
 //----------------------------------------------------------------------------
-/// Used in the "naked triples" algorithm. See SearchTriplesPattern() and SearchNakedTriples()
-struct Pos_vcand
+/// A naked or hidden subset found in a row/col/block. See FindNakedSubsets() and FindHiddenSubsets()
+struct UnitSubset
 {
-	index_t pos_index;            ///< Cell index in the row/col/block
-	std::vector<value_t> _values;  ///< Candidates for that cell
-	Pos_vcand( size_t p, const std::vector<value_t>& vect )
-		: pos_index(p), _values(vect)
-	{}
-	friend std::ostream& operator << ( std::ostream& s, const Pos_vcand& pvc )
-	{
-		s << "idx=" << (int)pvc.pos_index << ", values=";
-		for( auto v: pvc._values)
-			s << (int)v << '-';
-		s << ' ';
-		return s;
-	}
+	uint16_t _cells = 0;  ///< positions of the cells in the row/col/block, as a 9-bit mask
+	uint16_t _cands = 0;  ///< candidates of the subset, as a 9-bit mask (see Cell::GetCandMask())
 };
 
+/// Upper bound of the nb of subsets of a given size in a row/col/block: C(9,4)
+const size_t MAX_UNIT_SUBSETS = 126;
 
-NakedTriple SearchTriplesPattern( const std::vector<Pos_vcand>& v_cand );
+/// Fixed size storage for the output of FindNakedSubsets() and FindHiddenSubsets()
+using UnitSubsets = std::array<UnitSubset,MAX_UNIT_SUBSETS>;
 
 //----------------------------------------------------------------------------
-template<typename T>
-bool
-VectorsOverlap( const std::vector<T>& v1, const std::vector<T>& v2, size_t n )
+/// A row/col - block intersection, see GetIntersectionsTable()
+struct Intersection
 {
-	const std::vector<T>* pv1 = &v1;
-	const std::vector<T>* pv2 = &v2;
-	if( v1.size() < v2.size() )
-	{
-		pv1 = &v2;
-		pv2 = &v1;
-	}
-	assert( n <= pv1->size() );
-
-	size_t c=0;
-	for( const auto& e1: *pv1 )           // for each element of v1,
-		if( std::find(                    // if we find one
-				std::begin( *pv2 ),       // of the elements of v2
-				std::end( *pv2 ),
-				e1
-			) != std::end( *pv2 )
-		)
-			c++;                        // then we increment the counter
-
-	if( c >= n )                        // if more than 2 elements,
-		return true;                    // then, the vectors do overlap
-	return false;
-}
+	CellSet _line;      ///< cells of the row/col
+	CellSet _block;     ///< cells of the block
+	CellSet _inter;     ///< the 3 cells that are in both
+	EN_ORIENTATION  _orient = OR_ROW;
+};
+
+/// The 54 row/col - block intersections
+using IntersectionsTable = std::array<Intersection,54>;
+
+const IntersectionsTable& GetIntersectionsTable();
+CellSet IntersectionRemovals( const CellSet& board, const Intersection& inter, BecauseType bt );
+
+size_t FindHiddenSingles( const std::array<uint16_t,81>& cellMasks, std::array<uint16_t,81>& singles );
+size_t FindNakedSubsets(  const std::array<uint16_t,9>& cellMasks, size_t size, UnitSubsets& found );
+size_t FindHiddenSubsets( const std::array<uint16_t,9>& cellMasks, size_t size, UnitSubsets& found );
+
 //----------------------------------------------------------------------------
 
 
@@ -0,0 +1,191 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file alloc_count.cpp
+\brief Allocation counting, see alloc_count.h
+
+Only the nb of allocations and the requested sizes are counted, deallocations are not.
+The counters are atomic, as the X-cycles and forcing chains algorithms allocate from several threads.
+*/
+
+#include "alloc_count.h"
+#include "algorithms.h"
+
+//----------------------------------------------------------------------------
+/// Returns the name of phase \c phase, see EN_ALLOC_PHASE
+const char*
+GetAllocPhaseName( int phase )
+{
+	if( phase < ALG_END )
+		return GetString( static_cast<EN_ALGO>( phase ) );
+	switch( phase )
+	{
+		case AP_PARSING:  return "parsing";        break;
+		case AP_SOLVE:    return "Solve_misc";     break;
+		case AP_XC_GRAPH: return "X_cycles_graph"; break;
+		case AP_OTHER:    return "other";          break;
+		default: assert(0);
+	}
+	return "";
+}
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::array<std::atomic<size_t>,AP_END> g_nbAlloc;   // zero-initialized, being static
+std::array<std::atomic<size_t>,AP_END> g_nbBytes;
+
+/// Phase of the current thread
+thread_local int t_phase = AP_OTHER;
+
+void*
+CountedAlloc( std::size_t size )
+{
+	g_nbAlloc[t_phase].fetch_add( 1, std::memory_order_relaxed );
+	g_nbBytes[t_phase].fetch_add( size, std::memory_order_relaxed );
+	return std::malloc( size ? size : 1 );
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+int
+GetAllocPhase()
+{
+	return t_phase;
+}
+//----------------------------------------------------------------------------
+void
+SetAllocPhase( int phase )
+{
+	assert( phase >= 0 && phase < AP_END );
+	t_phase = phase;
+}
+//----------------------------------------------------------------------------
+AllocCount
+GetAllocCount( int phase )
+{
+	AllocCount out;
+	out._nb    = g_nbAlloc[phase].load();
+	out._bytes = g_nbBytes[phase].load();
+	return out;
+}
+//----------------------------------------------------------------------------
+/// Returns the counts of all the phases of Grid::Solve(): the algorithms, the X-cycles graphs, and Solve() itself
+AllocCount
+GetSolveAllocCount()
+{
+	AllocCount out;
+	for( int p=0; p<AP_END; p++ )
+		if( p != AP_PARSING && p != AP_OTHER )
+		{
+			auto ac = GetAllocCount( p );
+			out._nb    += ac._nb;
+			out._bytes += ac._bytes;
+		}
+	return out;
+}
+//----------------------------------------------------------------------------
+void
+ResetAllocCounts()
+{
+	for( int p=0; p<AP_END; p++ )
+	{
+		g_nbAlloc[p] = 0;
+		g_nbBytes[p] = 0;
+	}
+}
+//----------------------------------------------------------------------------
+/// Prints a line "alloc: <phase> <nb> <bytes>" for each phase having allocated, and one for the total of Grid::Solve()
+void
+PrintAllocCounts( std::ostream& s )
+{
+	for( int p=0; p<AP_END; p++ )
+	{
+		auto ac = GetAllocCount( p );
+		if( ac._nb )
+			s << "alloc: " << GetAllocPhaseName( p ) << ' ' << ac._nb << ' ' << ac._bytes << '\n';
+	}
+	auto ac = GetSolveAllocCount();
+	s << "alloc: Solve_total " << ac._nb << ' ' << ac._bytes << '\n';
+}
+//----------------------------------------------------------------------------
+void*
+operator new( std::size_t size )
+{
+	if( void* p = CountedAlloc( size ) )
+		return p;
+	throw std::bad_alloc();
+}
+
+void*
+operator new[]( std::size_t size )
+{
+	return operator new( size );
+}
+
+void*
+operator new( std::size_t size, const std::nothrow_t& ) noexcept
+{
+	return CountedAlloc( size );
+}
+
+void*
+operator new[]( std::size_t size, const std::nothrow_t& ) noexcept
+{
+	return CountedAlloc( size );
+}
+
+void
+operator delete( void* p ) noexcept
+{
+	std::free( p );
+}
+
+void
+operator delete[]( void* p ) noexcept
+{
+	std::free( p );
+}
+
+void
+operator delete( void* p, const std::nothrow_t& ) noexcept
+{
+	std::free( p );
+}
+
+void
+operator delete[]( void* p, const std::nothrow_t& ) noexcept
+{
+	std::free( p );
+}
+
+#endif // COUNT_ALLOCATIONS
@@ -0,0 +1,88 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file
+\brief Allocation counting, for the instrumentation build (<tt>make ALLOC=Y</tt>)
+
+When COUNT_ALLOCATIONS is defined, the global \c operator \c new and \c operator \c delete are replaced (see alloc_count.cpp),
+and each allocation is counted in the phase the calling thread is in: reading the grid, each algorithm (see EN_ALGO),
+the X-cycles graph build, ... The phases are set with the ALLOC_PHASE() macro, that does nothing in a normal build.
+*/
+
+#ifndef ALLOC_COUNT_H_
+#define ALLOC_COUNT_H_
+
+#include "grid.h"
+
+/// The phases the allocations are counted in: the algorithms (values of EN_ALGO), then these ones
+enum EN_ALLOC_PHASE
+{
+	AP_PARSING = ALG_END,  ///< reading the grid and computing the candidates
+	AP_SOLVE,              ///< Grid::Solve(), outside of the algorithms
+	AP_XC_GRAPH,           ///< building the X-cycles graphs, see FindCycles()
+	AP_OTHER,              ///< anything else
+	AP_END
+};
+
+const char* GetAllocPhaseName( int phase );
+
+#ifdef COUNT_ALLOCATIONS
+
+/// Nb of allocations and allocated bytes of a phase
+struct AllocCount
+{
+	size_t _nb    = 0;
+	size_t _bytes = 0;
+};
+
+int        GetAllocPhase();
+void       SetAllocPhase( int phase );
+AllocCount GetAllocCount( int phase );
+AllocCount GetSolveAllocCount();
+void       ResetAllocCounts();
+void       PrintAllocCounts( std::ostream& );
+
+/// Counts the allocations of the calling thread in phase \c phase until end of scope, then restores the previous one
+struct AllocPhase
+{
+	AllocPhase( int phase ): _prev( GetAllocPhase() )
+	{
+		SetAllocPhase( phase );
+	}
+	~AllocPhase()
+	{
+		SetAllocPhase( _prev );
+	}
+	private:
+		int _prev;
+};
+
+	#define ALLOC_PHASE( p ) AllocPhase allocPhase_( p )
+#else
+	#define ALLOC_PHASE( p )
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file als.cpp
+\brief Almost Locked Sets (ALS) algorithms implementation
+
+See:
+- http://www.sudokuwiki.org/Almost_Locked_Sets
+
+An ALS is a set of N cells, in a row/col/block, holding together N+1 candidates.
+A bivalue cell is an ALS of size 1.
+*/
+
+#include "grid.h"
+#include "header.h"
+#include "als.h"
+#include "algorithms.h"
+
+//----------------------------------------------------------------------------
+/// Builds the index of all the ALS of the grid, having at most \c maxCells cells
+/**
+- Input: the candidates of the 81 cells, as 9-bit masks (0 if the cell has a value), see Cell::GetCandMask()
+
+The subsets of cells of each unit are enumerated as 9-bit masks. To avoid duplicates, single cells are only
+taken from rows, and subsets of a block that lie in a single row or col are skipped.
+*/
+void
+BuildAlsIndex( const std::array<uint16_t,81>& cellMasks, size_t maxCells, AlsIndex& index )
+{
+	assert( maxCells <= ALS_MAX_CELLS );
+	const auto& units = GetUnitsTable();
+	index._nb = 0;
+	for( index_t u=0; u<27; u++ )
+	{
+		const auto& unit = units[u];
+		uint16_t unsolved = 0;
+		for( index_t j=0; j<9; j++ )
+			if( cellMasks[ unit[j] ] )
+				unsolved |= 1<<j;
+
+		for( uint16_t sub=1; sub<512; sub++ )
+		{
+			auto nbCells = std::bitset<9>( sub ).count();
+			if( (sub & unsolved) != sub || nbCells > maxCells )
+				continue;
+			if( nbCells == 1 && u >= 9 )                       // single cells only from rows
+				continue;
+
+			Als als;
+			bool sameRow = true, sameCol = true;
+			index_t first = 0;
+			for( index_t j=0; j<9; j++ )
+				if( sub & (1<<j) )
+				{
+					auto c = unit[j];
+					if( als._cells.none() )
+						first = c;
+					sameRow = sameRow && ( c/9 == first/9 );
+					sameCol = sameCol && ( c%9 == first%9 );
+					als._cells.set( c );
+					als._cands |= cellMasks[c];
+				}
+			if( std::bitset<9>( als._cands ).count() != nbCells+1 )
+				continue;
+			if( u >= 18 && nbCells > 1 && ( sameRow || sameCol ) )   // already found in the row/col
+				continue;
+
+			assert( index._nb < MAX_ALS );
+			index._als[ index._nb++ ] = als;
+		}
+	}
+}
+//----------------------------------------------------------------------------
+/// Returns the cells seeing all the cells of \c cells
+CellSet
+GetCommonPeers( const CellSet& cells )
+{
+	const auto& peers = GetPeerMasks();
+	CellSet out;
+	out.set();
+	for( auto c: cells )
+		out &= peers[c];
+	return out;
+}
+//----------------------------------------------------------------------------
+/// Returns the ALS index used by Algo_ALS_XZ() on this grid, created on first use
+AlsIndex&
+Grid::GetAlsIndex()
+{
+	if( !_alsIndex )
+		_alsIndex.reset( new AlsIndex );
+	return *_alsIndex;
+}
+//----------------------------------------------------------------------------
+/// ALS-XZ algorithm, see http://www.sudokuwiki.org/Almost_Locked_Sets
+/**
+Two ALS A and B, with no common cells, share a "restricted common candidate" X: all the cells holding X in A
+see all the cells holding X in B. So X can only be in one of them, and the other one is then a locked set.
+Thus, for any other common candidate Z, one of the Z cells of A or B holds Z: it can be removed from all the cells
+seeing all of them.
+
+All the ALS are built once in the index of the grid (see BuildAlsIndex() and Grid::GetAlsIndex()), and all the removals found
+are applied in one call.
+*/
+bool
+Algo_ALS_XZ( Grid& g )
+{
+	PRINT_ALGO_START_2;
+
+	auto& index = g.GetAlsIndex();
+	std::array<uint16_t,81> cellMasks;
+	std::array<CellSet,9> boards;
+	for( index_t c=0; c<81; c++ )
+	{
+		cellMasks[c] = g.getCell(c).GetCandMask();
+		for( index_t d=0; d<9; d++ )
+			if( cellMasks[c] & (1<<d) )
+				boards[d].set( c );
+	}
+	BuildAlsIndex( cellMasks, ALS_MAX_CELLS, index );
+	COUT( "ALS-XZ: " << index._nb << " ALS" );
+
+	std::array<CellSet,9> removals;
+	for( size_t a=0; a<index._nb; a++ )
+	{
+		const auto& alsA = index._als[a];
+		for( size_t b=a+1; b<index._nb; b++ )
+		{
+			const auto& alsB = index._als[b];
+			uint16_t common = alsA._cands & alsB._cands;
+			if( std::bitset<9>( common ).count() < 2 || ( alsA._cells & alsB._cells ).any() )
+				continue;
+
+			for( index_t x=0; x<9; x++ )                 // search for a restricted common candidate
+			{
+				if( !( common & (1<<x) ) )
+					continue;
+				auto xA = alsA._cells & boards[x];
+				auto xB = alsB._cells & boards[x];
+				if( ( GetCommonPeers( xA ) & xB ) != xB )
+					continue;
+
+				for( index_t z=0; z<9; z++ )
+					if( z != x && ( common & (1<<z) ) )
+					{
+						auto region = boards[z] & GetCommonPeers( ( alsA._cells | alsB._cells ) & boards[z] );
+						if( region.any() )
+						{
+							COUT( "ALS-XZ: X=" << (int)x+1 << " Z=" << (int)z+1 << ", " << region.count() << " removals" );
+							removals[z] |= region;
+						}
+					}
+			}
+		}
+	}
+
+	bool retval( false );
+	for( value_t val=1; val<10; val++ )
+		for( auto c: removals[val-1] )
+			if( g.getCell(c).RemoveCandidate( val ) )
+				retval = true;
+	return retval;
+}
+//----------------------------------------------------------------------------
@@ -0,0 +1,61 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file
+\brief specific header file for Almost Locked Sets (ALS) algorithms
+*/
+
+#ifndef ALS_H_
+#define ALS_H_
+
+#include <array>
+#include <bitset>
+
+//----------------------------------------------------------------------------
+/// An Almost Locked Set: N cells of a row/col/block holding together N+1 candidates
+struct Als
+{
+	CellSet _cells;      ///< cells of the set, see GetCellIndex()
+	uint16_t        _cands = 0;  ///< candidates of the set, as a 9-bit mask (see Cell::GetCandMask())
+};
+
+/// Max nb of cells of the ALS we search for, so that the search has a bounded cost
+const size_t ALS_MAX_CELLS = 4;
+
+/// Upper bound of the nb of ALS: 27 units, and C(9,1)+C(9,2)+C(9,3)+C(9,4) subsets of cells in each
+const size_t MAX_ALS = 27*(9+36+84+126);
+
+/// Flat storage of all the ALS of the grid, allocated once per grid (see Grid::GetAlsIndex()), see BuildAlsIndex()
+struct AlsIndex
+{
+	std::array<Als,MAX_ALS> _als;
+	size_t _nb = 0;
+};
+
+void BuildAlsIndex( const std::array<uint16_t,81>& cellMasks, size_t maxCells, AlsIndex& index );
+bool Algo_ALS_XZ( Grid& g );
+
+#endif
@@ -0,0 +1,304 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file coloring.cpp
+\brief Coloring algorithms implementation
+
+See:
+- http://www.sudokuwiki.org/Singles_Chains
+- http://www.sudokuwiki.org/Multi_Colouring
+- http://www.sudokuwiki.org/3D_Medusa
+
+For a given value, the cells linked by strong links are grouped into chains (with a union-find),
+and the cells of each chain get alternate colors: all the cells of one color hold the value, or none of them.
+
+3D Medusa does the same across values, on (cell,candidate) nodes, see MedusaRemovals().
+*/
+
+#include "grid.h"
+#include "header.h"
+#include "coloring.h"
+#include "aic.h"
+#include "algorithms.h"
+
+/// Max nb of chains of a value: each one holds at least 2 cells
+const size_t MAX_CHAINS = 81/2;
+
+//----------------------------------------------------------------------------
+/// A chain of cells linked by strong links, with its two colors
+struct ColorChain
+{
+	std::array<CellSet,2> _color;   ///< cells of each color
+	std::array<CellSet,2> _seen;    ///< cells seeing a cell of each color
+};
+//----------------------------------------------------------------------------
+/// Coloring of value \c val, returns the cells where it can be removed
+/**
+- Color wrap: if two cells of the same color see each other, that color is false
+- Color trap: a cell that sees both colors can not hold the value
+- Multi-coloring: if a color of a chain sees a color of another chain, then one of the two opposite colors is true,
+so a cell that sees both of them can not hold the value
+*/
+CellSet
+ColorValue( const CellSet& board, value_t val )
+{
+	CellSet removals;
+	auto links = GetStrongLinks( board );
+	if( links._nb == 0 )
+		return removals;
+
+	ParityUnionFind<81> uf;
+	for( index_t i=0; i<links._nb; i++ )
+		uf.Union( links._links[i].first, links._links[i].second );
+
+	const auto& peers = GetPeerMasks();
+	std::array<ColorChain,MAX_CHAINS> chains;
+	std::array<int8_t,81> chainIdx;
+	chainIdx.fill( -1 );
+	size_t nbChains = 0;
+	for( index_t i=0; i<links._nb; i++ )
+		for( auto c: { links._links[i].first, links._links[i].second } )
+		{
+			uint8_t parity;
+			auto root = uf.Find( c, parity );
+			if( chainIdx[root] == -1 )
+				chainIdx[root] = nbChains++;
+			auto& chain = chains[ chainIdx[root] ];
+			chain._color[parity].set( c );
+			chain._seen[parity] |= peers[c];
+		}
+
+	for( size_t i=0; i<nbChains; i++ )
+	{
+		const auto& ch = chains[i];
+		for( int k=0; k<2; k++ )
+			if( ( ch._seen[k] & ch._color[k] ).any() )
+			{
+				COUT( "Coloring: value " << (int)val << ", color wrap" );
+				removals |= ch._color[k];
+			}
+		auto trap = board & ch._seen[0] & ch._seen[1];
+		if( trap.any() )
+		{
+			COUT( "Coloring: value " << (int)val << ", color trap" );
+			removals |= trap;
+		}
+		for( size_t j=i+1; j<nbChains; j++ )
+			for( int k=0; k<2; k++ )
+				for( int l=0; l<2; l++ )
+					if( ( ch._seen[k] & chains[j]._color[l] ).any() )
+					{
+						auto multi = board & ch._seen[!k] & chains[j]._seen[!l];
+						if( multi.any() )
+						{
+							COUT( "Coloring: value " << (int)val << ", multi-coloring" );
+							removals |= multi;
+						}
+					}
+	}
+	return removals & board;
+}
+//----------------------------------------------------------------------------
+/// Simple coloring and multi-coloring algorithm, see ColorValue()
+/**
+All the removals found on the 9 values are applied in one call.
+*/
+bool
+Algo_Coloring( Grid& g )
+{
+	PRINT_ALGO_START_2;
+
+	bool retval( false );
+	for( value_t val=1; val<10; val++ )
+	{
+		auto removals = ColorValue( g.GetCandidateBoard( val ), val );
+		for( auto c: removals )
+			if( g.getCell(c).RemoveCandidate( val ) )
+				retval = true;
+	}
+	return retval;
+}
+//----------------------------------------------------------------------------
+/// Max nb of Medusa nodes, a node is a (cell,candidate) pair. See GetNodeIndex()
+const size_t NB_MEDUSA_NODES = 81*9;
+
+/// Candidate boards of the 9 values, see Grid::GetCandidateBoard()
+using Boards = std::array<CellSet,9>;
+
+//----------------------------------------------------------------------------
+/// Checks the six 3D Medusa rules on a chain (a set of nodes linked by strong links, with their two colors)
+/**
+- \c col: for each color and each value, the cells holding that value with that color
+- \c removals: the candidates that can be removed are added here
+
+See http://www.sudokuwiki.org/3D_Medusa
+*/
+void
+CheckMedusaRules( const Boards& boards, const std::array<Boards,2>& col, Boards& removals )
+{
+	const auto& peers = GetPeerMasks();
+
+	std::array<Boards,2> seen;                  // for each color and value, the cells seeing a cell of that color
+	std::array<CellSet,2> cells;        // for each color, the cells holding a candidate of that color
+	CellSet unsolved;
+	for( index_t d=0; d<9; d++ )
+	{
+		unsolved |= boards[d];
+		for( int k=0; k<2; k++ )
+		{
+			cells[k] |= col[k][d];
+			for( auto c: col[k][d] )
+				seen[k][d] |= peers[c];
+		}
+	}
+
+	for( int k=0; k<2; k++ )
+	{
+		bool isFalse = false;
+		for( index_t d=0; d<9; d++ )
+		{
+			for( index_t e=d+1; e<9; e++ )          // rule 1: a color twice in a cell
+				if( ( col[k][d] & col[k][e] ).any() )
+					isFalse = true;
+			if( ( col[k][d] & seen[k][d] ).any() )   // rule 2: a color twice in a unit
+				isFalse = true;
+		}
+
+		CellSet emptied = unsolved & ~cells[0] & ~cells[1];   // rule 6: an uncolored cell that would be emptied by a color
+		for( index_t d=0; d<9; d++ )
+			emptied &= ~boards[d] | seen[k][d];
+		if( emptied.any() )
+			isFalse = true;
+
+		if( isFalse )
+		{
+			COUT( "Medusa: color " << k << " is false" );
+			for( index_t d=0; d<9; d++ )
+			{
+				removals[d] |= col[k][d];                         // the candidates of that color are false,
+				for( index_t e=0; e<9; e++ )                      // and the ones of the other color are true
+					if( e != d )
+						removals[e] |= col[!k][d] & boards[e];
+			}
+			return;
+		}
+	}
+
+	auto both = cells[0] & cells[1];
+	for( index_t d=0; d<9; d++ )
+	{
+		auto uncolored = boards[d] & ~col[0][d] & ~col[1][d];
+		removals[d] |= uncolored & both;                                // rule 3: two colors in a cell
+		removals[d] |= uncolored & seen[0][d] & seen[1][d];             // rule 4: two colors elsewhere
+		removals[d] |= uncolored & seen[0][d] & cells[1];               // rule 5: two colors, in a unit and in the cell
+		removals[d] |= uncolored & seen[1][d] & cells[0];
+	}
+}
+//----------------------------------------------------------------------------
+/// 3D Medusa: coloring across values, returns the candidates that can be removed, for each value
+/**
+The nodes are (cell,candidate) pairs. They are linked by strong links: conjugate pairs of each value
+(see GetStrongLinks()) and the two candidates of bivalue cells. The chains are built with a union-find,
+and their colors are then checked with CheckMedusaRules().
+*/
+Boards
+MedusaRemovals( const Boards& boards )
+{
+	ParityUnionFind<NB_MEDUSA_NODES> uf;
+	std::bitset<NB_MEDUSA_NODES> linked;
+	for( index_t d=0; d<9; d++ )
+	{
+		auto links = GetStrongLinks( boards[d] );
+		for( index_t i=0; i<links._nb; i++ )
+		{
+			auto n1 = GetNodeIndex( links._links[i].first,  d+1 );
+			auto n2 = GetNodeIndex( links._links[i].second, d+1 );
+			uf.Union( n1, n2 );
+			linked.set( n1 );
+			linked.set( n2 );
+		}
+	}
+	for( index_t c=0; c<81; c++ )                                 // bivalue cells
+	{
+		std::array<value_t,2> v;
+		index_t n = 0;
+		for( index_t d=0; d<9; d++ )
+			if( boards[d][c] && n++ < 2 )
+				v[n-1] = d+1;
+		if( n == 2 )
+		{
+			auto n1 = GetNodeIndex( c, v[0] );
+			auto n2 = GetNodeIndex( c, v[1] );
+			uf.Union( n1, n2 );
+			linked.set( n1 );
+			linked.set( n2 );
+		}
+	}
+
+	std::array<uint16_t,NB_MEDUSA_NODES> root;
+	std::array<uint8_t,NB_MEDUSA_NODES>  parity;
+	for( uint16_t n=0; n<NB_MEDUSA_NODES; n++ )
+		if( linked[n] )
+			root[n] = uf.Find( n, parity[n] );
+
+	Boards removals;
+	std::bitset<NB_MEDUSA_NODES> done;
+	for( uint16_t r=0; r<NB_MEDUSA_NODES; r++ )                   // for each chain
+	{
+		if( !linked[r] || done[root[r]] )
+			continue;
+		done.set( root[r] );
+		std::array<Boards,2> col;
+		for( uint16_t n=r; n<NB_MEDUSA_NODES; n++ )
+			if( linked[n] && root[n] == root[r] )
+				col[parity[n]][n%9].set( n/9 );
+		CheckMedusaRules( boards, col, removals );
+	}
+	return removals;
+}
+//----------------------------------------------------------------------------
+/// 3D Medusa algorithm, see MedusaRemovals()
+/**
+All the removals found on all the chains are applied in one call.
+*/
+bool
+Algo_Medusa( Grid& g )
+{
+	PRINT_ALGO_START_2;
+
+	Boards boards;
+	for( value_t val=1; val<10; val++ )
+		boards[val-1] = g.GetCandidateBoard( val );
+
+	auto removals = MedusaRemovals( boards );
+	bool retval( false );
+	for( value_t val=1; val<10; val++ )
+		for( auto c: removals[val-1] )
+			if( g.getCell(c).RemoveCandidate( val ) )
+				retval = true;
+	return retval;
+}
+//----------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file
+\brief specific header file for coloring algorithms
+*/
+
+#ifndef COLORING_H_
+#define COLORING_H_
+
+#include <array>
+#include <bitset>
+
+//----------------------------------------------------------------------------
+/// Fixed size union-find, that also holds the parity (color) of each element relative to the root of its set
+/**
+Used to group the nodes linked by strong links into chains, and give them alternate colors.
+*/
+template<size_t N>
+class ParityUnionFind
+{
+	public:
+		ParityUnionFind()
+		{
+			for( size_t i=0; i<N; i++ )
+				_parent[i] = i;
+			_parity.fill( 0 );
+		}
+
+/// Returns the root of the set of \c i, and sets \c parity to the parity of \c i relative to that root
+		uint16_t Find( uint16_t i, uint8_t& parity )
+		{
+			uint16_t root = i;
+			parity = 0;
+			while( _parent[root] != root )
+			{
+				parity ^= _parity[root];
+				root = _parent[root];
+			}
+			uint16_t c = i;                   // path compression
+			uint8_t  p = parity;
+			while( c != root )
+			{
+				auto next  = _parent[c];
+				auto nextP = p ^ _parity[c];
+				_parent[c] = root;
+				_parity[c] = p;
+				c = next;
+				p = nextP;
+			}
+			return root;
+		}
+
+/// Joins the sets of \c a and \c b, giving them opposite parities.
+/// Returns false if they already are in the same set with the same parity (which means the grid is invalid)
+		bool Union( uint16_t a, uint16_t b )
+		{
+			uint8_t pa, pb;
+			auto ra = Find( a, pa );
+			auto rb = Find( b, pb );
+			if( ra == rb )
+				return pa != pb;
+			_parent[rb] = ra;
+			_parity[rb] = pa ^ pb ^ 1;
+			return true;
+		}
+
+	private:
+		std::array<uint16_t,N> _parent;
+		std::array<uint8_t,N>  _parity;
+};
+//----------------------------------------------------------------------------
+
+CellSet ColorValue( const CellSet& board, value_t val );
+bool Algo_Coloring( Grid& g );
+
+std::array<CellSet,9> MedusaRemovals( const std::array<CellSet,9>& boards );
+bool Algo_Medusa( Grid& g );
+
+#endif
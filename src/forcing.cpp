@@ -0,0 +1,375 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file forcing.cpp
+\brief Forcing chains (trial based) algorithms implementation
+
+See:
+- http://www.sudokuwiki.org/Nishio_Forcing_Chains
+- http://www.sudokuwiki.org/Cell_Forcing_Chains
+- http://www.sudokuwiki.org/Unit_Forcing_Chains
+
+Each candidate is tried on a copy of the grid (see Snapshot), and only singles are propagated.
+This is the last resort before giving up, as it is by far the most expensive algorithm.
+*/
+
+#include <thread>
+#include <atomic>
+
+#include "grid.h"
+#include "header.h"
+#include "forcing.h"
+#include "algorithms.h"
+#include "alloc_count.h"
+
+/// Mask of all the 9 candidates
+const uint16_t ALL_CANDS = 0x1FF;
+
+//----------------------------------------------------------------------------
+/// Builds the snapshot of the grid
+Snapshot
+TakeSnapshot( const Grid& g )
+{
+	Snapshot s;
+	for( index_t c=0; c<81; c++ )
+	{
+		const auto& cell = g.getCell(c);
+		s._values[c] = cell.GetValue();
+		s._cands[c]  = ( cell.GetValue() == 0 ? cell.GetCandMask() : 0 );
+	}
+	return s;
+}
+//----------------------------------------------------------------------------
+/// Places value \c val in cell \c cell, and removes it from the candidates of the peers.
+/// Returns false if a peer already holds that value
+bool
+PlaceValue( Snapshot& s, index_t cell, value_t val )
+{
+	s._values[cell] = val;
+	s._cands[cell]  = 0;
+	uint16_t bit = 1 << (val-1);
+	for( auto p: GetPeersTable()[cell] )
+	{
+		if( s._values[p] == val )
+			return false;
+		s._cands[p] &= ~bit;
+	}
+	return true;
+}
+//----------------------------------------------------------------------------
+/// Propagates the naked and hidden singles, until nothing changes. Returns false if a contradiction shows up:
+/**
+- two cells of a row/col/block with the same value,
+- a cell with no value and no candidate,
+- a value that has no place left in a row/col/block,
+- a cell that is the only place of two values in its row/col/block.
+*/
+bool
+PropagateSingles( Snapshot& s )
+{
+	for( index_t c=0; c<81; c++ )                    // so that the candidates are consistent with the values
+		if( s._values[c] != 0 )
+			if( !PlaceValue( s, c, s._values[c] ) )
+				return false;
+
+	bool changed = true;
+	while( changed )
+	{
+		changed = false;
+		for( index_t c=0; c<81; c++ )                // naked singles
+		{
+			if( s._values[c] != 0 )
+				continue;
+			auto mask = s._cands[c];
+			if( mask == 0 )
+				return false;
+			if( ( mask & (mask-1) ) == 0 )
+			{
+				if( !PlaceValue( s, c, GetMaskValue( mask ) ) )
+					return false;
+				changed = true;
+			}
+		}
+
+		for( const auto& unit: GetUnitsTable() )     // hidden singles
+		{
+			uint16_t once   = 0;
+			uint16_t twice  = 0;
+			uint16_t placed = 0;
+			for( auto c: unit )
+			{
+				twice |= once & s._cands[c];
+				once  |= s._cands[c];
+				if( s._values[c] != 0 )
+					placed |= 1 << (s._values[c]-1);
+			}
+			if( ( once | placed ) != ALL_CANDS )
+				return false;
+			uint16_t uniq = once & ~twice;
+			for( auto c: unit )
+			{
+				auto single = s._cands[c] & uniq;
+				if( single == 0 )
+					continue;
+				if( ( single & (single-1) ) != 0 )
+					return false;
+				if( !PlaceValue( s, c, GetMaskValue( single ) ) )
+					return false;
+				changed = true;
+			}
+		}
+	}
+	return true;
+}
+//----------------------------------------------------------------------------
+/// For each cell, the value (as a mask) or the candidates left
+std::array<uint16_t,81>
+GetPossible( const Snapshot& s )
+{
+	std::array<uint16_t,81> out;
+	for( index_t c=0; c<81; c++ )
+		out[c] = ( s._values[c] != 0 ? 1 << (s._values[c]-1) : s._cands[c] );
+	return out;
+}
+//----------------------------------------------------------------------------
+/// Counts the solutions of the grid by trial and error, stopping as soon as \c max have been found.
+/// If there is some, \c s holds the first one found
+/**
+Not a solving algorithm: only used to get the solution beforehand, see GlobData::useOracle.
+The cell with the less candidates is tried first, and the singles are propagated after each guess.
+*/
+size_t
+CountSolutions( Snapshot& s, size_t max )
+{
+	if( !PropagateSingles( s ) )
+		return 0;
+
+	index_t best = 81;
+	size_t  bestNb = 10;
+	for( index_t c=0; c<81; c++ )
+		if( s._values[c] == 0 )
+		{
+			auto nb = std::bitset<9>( s._cands[c] ).count();
+			if( nb < bestNb )
+			{
+				best = c;
+				bestNb = nb;
+			}
+		}
+	if( best == 81 )                                  // all the cells have a value
+		return 1;
+
+	size_t nb = 0;
+	Snapshot first( s );
+	for( auto v: CandSet( s._cands[best] ) )
+	{
+		Snapshot trial( s );
+		if( PlaceValue( trial, best, v ) )
+		{
+			auto n = CountSolutions( trial, max-nb );
+			if( n != 0 && nb == 0 )
+				first = trial;
+			nb += n;
+			if( nb >= max )
+				break;
+		}
+	}
+	if( nb != 0 )
+		s = first;
+	return nb;
+}
+//----------------------------------------------------------------------------
+/// Solves the grid by trial and error, returns false if it has no solution. If several, \c s holds the first one found
+bool
+SolveBruteForce( Snapshot& s )
+{
+	return CountSolutions( s, 1 ) != 0;
+}
+//----------------------------------------------------------------------------
+/// Result of trying a candidate, see ForcingRemovals()
+struct TrialResult
+{
+	bool _valid = false;                    ///< false if a contradiction showed up
+	std::array<uint16_t,81> _possible;      ///< see GetPossible()
+};
+//----------------------------------------------------------------------------
+/// Searches the candidates that can be removed, by trying each candidate of the grid \c base.
+/// Returns the contradiction found if the grid is invalid, along with its location in \c where
+/**
+Each candidate is placed on a copy of the grid, and the singles are propagated (see PropagateSingles()).
+A set of trials covering all the possibilities (a "net") is then considered: the candidates of a cell,
+or the cells of a row/col/block holding a given candidate. In every case, one of the trials is true, so a candidate
+that is not left by any of the valid trials of the net can be removed.
+This includes the candidates whose trial leads to a contradiction (Nishio).
+
+The trials are independent, so if \c nbThreads > 1, they are shared between that nb of threads.
+The removals are added to \c removals, as 9-bit masks.
+
+If all the trials of a cell fail, the cell can hold no value (CO_EmptyCell), and if all the trials of a value
+in a row/col/block fail, the value has no place left in it (CO_MissingValue).
+*/
+EN_CONTRADICTION
+ForcingRemovals( const Snapshot& base, int nbThreads, std::array<uint16_t,81>& removals, index_t& where )
+{
+	Snapshot start( base );
+	if( !PropagateSingles( start ) )
+	{
+		where = 0;
+		return CO_Propagation;
+	}
+	auto startPossible = GetPossible( start );         // the singles found without any trial
+	for( index_t c=0; c<81; c++ )
+		removals[c] |= base._cands[c] & ~startPossible[c];
+
+	std::vector<std::pair<index_t,value_t>> v_trials;
+	std::array<int16_t,81*9> trialIdx;                 // index of the trial of each (cell,value), see GetNodeIndex()
+	trialIdx.fill( -1 );
+	for( index_t c=0; c<81; c++ )
+		for( auto v: CandSet( start._cands[c] ) )
+		{
+			trialIdx[ GetNodeIndex( c, v ) ] = v_trials.size();
+			v_trials.push_back( std::make_pair( c, v ) );
+		}
+	if( v_trials.empty() )
+		return CO_None;
+
+	std::vector<TrialResult> v_res( v_trials.size() );
+	std::atomic<size_t> nextTrial( 0 );
+	auto worker = [&]()
+	{
+		ALLOC_PHASE( ALG_FORCING );
+		size_t k;
+		while( (k = nextTrial++) < v_trials.size() )
+		{
+			Snapshot s( start );
+			auto& res = v_res[k];
+			res._valid = PlaceValue( s, v_trials[k].first, v_trials[k].second ) && PropagateSingles( s );
+			res._possible = GetPossible( s );
+		}
+	};
+	std::vector<std::thread> v_threads;
+	for( int i=1; i<nbThreads; i++ )
+		v_threads.emplace_back( worker );
+	worker();
+	for( auto& t: v_threads )
+		t.join();
+
+	EN_CONTRADICTION co = CO_None;
+	auto processNet = [&]( const std::array<int16_t,9>& net, size_t nb, EN_CONTRADICTION netCo, index_t netWhere )
+	{
+		std::array<uint16_t,81> possible;
+		possible.fill( 0 );
+		bool found = false;
+		for( size_t i=0; i<nb; i++ )
+			if( v_res[ net[i] ]._valid )
+			{
+				found = true;
+				for( index_t c=0; c<81; c++ )
+					possible[c] |= v_res[ net[i] ]._possible[c];
+			}
+		if( !found )                                   // all the trials failed
+		{
+			if( co == CO_None )
+			{
+				co = netCo;
+				where = netWhere;
+			}
+			return;
+		}
+		for( index_t c=0; c<81; c++ )
+			removals[c] |= base._cands[c] & ~possible[c];
+	};
+
+	std::array<int16_t,9> net;
+	for( index_t c=0; c<81; c++ )                       // cell forcing nets
+	{
+		size_t nb = 0;
+		for( value_t v=1; v<10; v++ )
+			if( trialIdx[ GetNodeIndex( c, v ) ] != -1 )
+				net[nb++] = trialIdx[ GetNodeIndex( c, v ) ];
+		if( nb > 0 )
+			processNet( net, nb, CO_EmptyCell, c );
+	}
+	const auto& units = GetUnitsTable();
+	for( index_t u=0; u<27; u++ )                       // unit forcing nets
+		for( value_t v=1; v<10; v++ )
+		{
+			const auto& unit = units[u];
+			size_t nb = 0;
+			for( auto c: unit )
+				if( trialIdx[ GetNodeIndex( c, v ) ] != -1 )
+					net[nb++] = trialIdx[ GetNodeIndex( c, v ) ];
+			if( nb > 0 )
+				processNet( net, nb, CO_MissingValue, u );
+		}
+	return co;
+}
+//----------------------------------------------------------------------------
+/// Nishio, cell and unit forcing chains, see ForcingRemovals()
+/**
+If \c -j is given (see GlobData::nbThreads), the trials are processed concurrently.
+This is disabled when verbose, to avoid mixing outputs.
+
+If the grid shows up as invalid (including when all the candidates of a cell would be removed),
+this is reported through the grid status (see Grid::SetContradiction()), and nothing is removed.
+*/
+bool
+Algo_Forcing( Grid& g )
+{
+	PRINT_ALGO_START_2;
+
+	int nbThreads = ( g_data.Verbose ? 1 : g_data.nbThreads );
+	std::array<uint16_t,81> removals;
+	removals.fill( 0 );
+	index_t where = 0;
+	auto co = ForcingRemovals( TakeSnapshot( g ), nbThreads, removals, where );
+	for( index_t c=0; c<81 && co == CO_None; c++ )
+		if( removals[c] != 0 && removals[c] == g.getCell(c).GetCandMask() )
+		{
+			co = CO_EmptyCell;
+			where = c;
+		}
+	if( co != CO_None )
+	{
+		COUT( "Forcing: grid is invalid, " << GetString( co ) );
+		g.SetContradiction( co, where );
+		return false;
+	}
+
+	bool retval( false );
+	for( index_t c=0; c<81; c++ )
+	{
+		auto& cell = g.getCell(c);
+		if( removals[c] != 0 )
+		{
+			COUT( "Forcing: " << cell.GetPos() << ", removing candidates mask " << removals[c] );
+			if( cell.RemoveCandidates( removals[c] ) )
+				retval = true;
+		}
+	}
+	return retval;
+}
+//----------------------------------------------------------------------------
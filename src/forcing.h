@@ -0,0 +1,57 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file
+\brief specific header file for forcing chains (trial based) algorithms
+*/
+
+#ifndef FORCING_H_
+#define FORCING_H_
+
+#include <array>
+#include <type_traits>
+
+//----------------------------------------------------------------------------
+/// A fixed size copy of the grid state, used to try a candidate without touching the grid. See TakeSnapshot()
+/**
+Only holds plain arrays, so that copying a snapshot is a mere memcpy.
+*/
+struct Snapshot
+{
+	std::array<uint16_t,81> _cands;   ///< candidates of each cell, as 9-bit masks (see Cell::GetCandMask()), 0 if the cell has a value
+	std::array<value_t,81>  _values;  ///< value of each cell, 0 if unknown
+};
+
+static_assert( std::is_trivially_copyable<Snapshot>::value, "Snapshot must be memcpy-able" );
+
+Snapshot TakeSnapshot( const Grid& g );
+bool PlaceValue( Snapshot& s, index_t cell, value_t val );
+bool PropagateSingles( Snapshot& s );
+size_t CountSolutions( Snapshot& s, size_t max );
+bool SolveBruteForce( Snapshot& s );
+bool Algo_Forcing( Grid& g );
+
+#endif
@@ -33,20 +33,36 @@ Licence: GPLv3
 
 #include "grid.h"
 #include "algorithms.h"
+#include "alloc_count.h"
 
 #include "header.h"
 #include <fstream>
 
 
 GlobData g_data;
+thread_local bool QuietOutput::s_quiet = false;
 
 //----------------------------------------------------------------------------
+/// Counts a step, and prints it if \c level is enabled
+/**
+The message is built here and only if printed, so that a step costs no allocation when logging is off.
+If the changes of the grid are recorded (see Grid::FindHint()), the step is counted in the record.
+*/
 void
-LogStep( int level, const Cell& cell, std::string msg )
+LogStep( int level, const Cell& cell, const char* action, value_t val, const Because& bec )
 {
-	++g_data.NbSteps;
-	if( level <= g_data.LogSteps )
-		std::cout << "*** step " << g_data.NbSteps << ": CELL " << cell.GetPos() << ": " << msg << '\n';
+	auto rec = cell.GetRecord();
+	if( rec )
+		++rec->_nbSteps;
+	else
+		++g_data.NbSteps;
+	if( level <= LogLevel() )
+	{
+		std::cout << "*** step " << g_data.NbSteps << ": CELL " << cell.GetPos() << ": " << action << ' ' << (int)val;
+		if( bec._bt != B_noReason )
+			std::cout << " because " << bec.getString();
+		std::cout << '\n';
+	}
 }
 //----------------------------------------------------------------------------
 /// \todo 20201115: is this used somewhere ???
@@ -70,6 +86,84 @@ operator << ( std::ostream& s, const Viewtable& vt )
 }
 #endif
 //----------------------------------------------------------------------------
+/// Returns the table of the cell indexes of each unit (computed only once)
+const UnitsTable&
+GetUnitsTable()
+{
+	static UnitsTable units = []()
+	{
+		UnitsTable t;
+		for( index_t i=0; i<9; i++ )
+			for( index_t j=0; j<9; j++ )
+			{
+				t[i][j]    = GetCellIndex( pos_t(i,j) );                 // rows
+				t[9+i][j]  = GetCellIndex( pos_t(j,i) );                 // cols
+				t[18+i][j] = GetCellIndex( getPosFromBlockIndex(i,j) );  // blocks
+			}
+		return t;
+	}();
+	return units;
+}
+//----------------------------------------------------------------------------
+/// Returns the table of the peers of each cell (computed only once)
+const PeersTable&
+GetPeersTable()
+{
+	static PeersTable peers = []()
+	{
+		PeersTable t;
+		for( index_t c=0; c<81; c++ )
+		{
+			auto p1 = GetPosFromCellIndex( c );
+			index_t n = 0;
+			for( index_t c2=0; c2<81; c2++ )
+			{
+				auto p2 = GetPosFromCellIndex( c2 );
+				if( c2 != c && ( p1.first == p2.first || p1.second == p2.second || GetBlockIndex(p1) == GetBlockIndex(p2) ) )
+					t[c][n++] = c2;
+			}
+			assert( n == 20 );
+		}
+		return t;
+	}();
+	return peers;
+}
+//----------------------------------------------------------------------------
+/// Returns the peers of each cell as 81-bit masks (computed only once). See GetPeersTable()
+const PeerMasks&
+GetPeerMasks()
+{
+	static PeerMasks masks = []()
+	{
+		PeerMasks t;
+		const auto& peers = GetPeersTable();
+		for( index_t c=0; c<81; c++ )
+			for( auto p: peers[c] )
+				t[c].set( p );
+		return t;
+	}();
+	return masks;
+}
+//----------------------------------------------------------------------------
+/// Returns the strong links of a value, given its candidate board (see Grid::GetCandidateBoard()):
+/// the units holding that value in exactly two cells
+StrongLinks
+GetStrongLinks( const CellSet& board )
+{
+	StrongLinks out;
+	for( const auto& unit: GetUnitsTable() )
+	{
+		index_t n = 0;
+		std::array<index_t,2> pos;
+		for( auto c: unit )
+			if( board[c] && n++ < 2 )
+				pos[n-1] = c;
+		if( n == 2 )
+			out._links[ out._nb++ ] = std::make_pair( pos[0], pos[1] );
+	}
+	return out;
+}
+//----------------------------------------------------------------------------
 void
 DrawLine( std::ostream& s )
 {
@@ -221,6 +315,28 @@ Grid::Grid()
 		}
 }
 //----------------------------------------------------------------------------
+/// Copy constructor: the cells of the copy must point to the status of the copy, see InitStatus()
+Grid::Grid( const Grid& other ): _data( other._data ), _status( other._status )
+{
+	for( auto& row: _data )
+		for( auto& cell: row )
+			cell.SetStatus( &_status );
+}
+//----------------------------------------------------------------------------
+Grid&
+Grid::operator = ( const Grid& other )
+{
+	_data   = other._data;
+	_status = other._status;
+	for( auto& row: _data )
+		for( auto& cell: row )
+			cell.SetStatus( &_status );
+	return *this;
+}
+//----------------------------------------------------------------------------
+Grid::~Grid()
+{}
+//----------------------------------------------------------------------------
 /// Returns false if puzzle is inconsistent, and prints message
 bool
 Grid::Check( EN_ORIENTATION orient ) const
@@ -280,6 +396,68 @@ Grid::Check() const
 	return true;
 }
 //----------------------------------------------------------------------------
+/// Checks the units changed since last call (see GridStatus), returns false if one of them is not valid
+/**
+Much cheaper than Check(), as only the changed units are processed, once per call.
+For each of them, the values and candidates of the cells are compared to the status counters,
+so that this also checks that the status is up to date.
+The error found is also recorded in the status (see GridStatus::SetContradiction()).
+*/
+bool
+Grid::CheckChanges()
+{
+	const auto& units = GetUnitsTable();
+	for( index_t u=0; u<27; u++ )
+	{
+		if( !( _status._changed & (1<<u) ) )
+			continue;
+		uint16_t placed = 0;
+		std::array<uint8_t,9> places;
+		places.fill( 0 );
+		for( auto c: units[u] )
+		{
+			const auto& cell = getCell( c );
+			auto mask = cell.GetCandMask();
+			auto val = cell.GetValue();
+			if( val != 0 )
+			{
+				if( placed & (1<<(val-1)) )
+				{
+					std::cout << "Checking unit " << (int)u << ": Error, value " << (int)val << " is present twice\n";
+					_status.SetContradiction( CO_DuplicateValue, u );
+					return false;
+				}
+				placed |= 1<<(val-1);
+				mask |= 1<<(val-1);
+			}
+			else
+				if( mask == 0 )
+				{
+					std::cout << "Checking unit " << (int)u << ": Error, cell " << cell.GetPos() << " has no candidate\n";
+					_status.SetContradiction( CO_EmptyCell, c );
+					return false;
+				}
+			for( index_t d=0; d<9; d++ )
+				if( mask & (1<<d) )
+					places[d]++;
+		}
+		if( placed != _status._placed[u] || places != _status._places[u] )
+		{
+			std::cout << "Checking unit " << (int)u << ": Error, status is not up to date\n";
+			_status.SetContradiction( CO_StaleStatus, u );
+			return false;
+		}
+		if( std::count( places.begin(), places.end(), 0 ) != 0 )
+		{
+			std::cout << "Checking unit " << (int)u << ": Error, a value has no place left\n";
+			_status.SetContradiction( CO_MissingValue, u );
+			return false;
+		}
+	}
+	_status._changed = 0;
+	return true;
+}
+//----------------------------------------------------------------------------
 /// Erase all candidates from cells that have a value
 void
 Grid::initCandidates()
@@ -296,6 +474,52 @@ Grid::initCandidates()
 	}
 }
 //----------------------------------------------------------------------------
+/// Computes the status of the grid from scratch, and makes the cells update it from now on. See \c GridStatus
+/**
+Once this is done, a contradiction is found as soon as it happens, see Solve()
+*/
+void
+Grid::InitStatus()
+{
+	_status = GridStatus();
+	for( auto& p: _status._places )
+		p.fill( 0 );
+	_status._placed.fill( 0 );
+
+	for( index_t c=0; c<81; c++ )
+	{
+		Cell& cell = getCell( c );
+		cell.SetStatus( &_status );
+		auto units = GridStatus::GetUnits( cell.GetPos() );
+		auto val = cell.GetValue();
+		if( val != 0 )
+		{
+			for( auto u: units )
+			{
+				if( _status._placed[u] & (1<<(val-1)) )
+					_status.SetContradiction( CO_DuplicateValue, u );
+				_status._placed[u] |= 1<<(val-1);
+			}
+		}
+		else
+			if( cell.NbCandidates() == 0 )
+				_status.SetContradiction( CO_EmptyCell, c );
+
+		auto mask = cell.GetCandMask();
+		if( val != 0 )
+			mask |= 1<<(val-1);
+		for( auto u: units )
+			for( index_t d=0; d<9; d++ )
+				if( mask & (1<<d) )
+					_status._places[u][d]++;
+	}
+	for( index_t u=0; u<27; u++ )
+		for( index_t d=0; d<9; d++ )
+			if( _status._places[u][d] == 0 )
+				_status.SetContradiction( CO_MissingValue, u );
+	_status._upToDate = true;
+}
+//----------------------------------------------------------------------------
 bool
 Grid::saveToFile( std::string fn ) const
 {
@@ -331,6 +555,7 @@ Grid::loadFromFile( std::string fn )
 		return false;
 	}
 	int li = 0;
+	_status._upToDate = false;      // the values are set without updating it
 	std::string line;
 	while( std::getline( infile, line ) )
 	{
@@ -382,6 +607,7 @@ Grid::buildFromString( std::string in )
 		std::cout << "Error: Incorrect size of input string, has " << in.size() << " characters\n";
 		return false;
 	}
+	_status._upToDate = false;      // the values are set without updating it
 	for( int li=0; li<9; li++ )
 	{
 		for( int col=0; col<9; col++ )
@@ -448,65 +674,16 @@ Grid::PrintAll( std::ostream& s, std::string txt ) const
 */
 }
 //----------------------------------------------------------------------------
-/// Returns a set of cell positions that are on same row/col/block as \c src and share some common properties
-/**
-See:
-- EN_GOCMODE
-- Grid::GetOtherCells_cand()
-- Grid::GetOtherCells_nbc()
-*/
-std::vector<pos_t>
-Grid::GetOtherCells( const Cell& src, int arg, EN_ORIENTATION orient, EN_GOCMODE goc_mode ) const
+/// Returns the set of cells (by index, see GetCellIndex()) holding candidate \c val
+CellSet
+Grid::GetCandidateBoard( value_t val ) const
 {
-	std::vector<pos_t> out;
-	auto row = src.GetPos().first;
-	auto col = src.GetPos().second;
-
-	View_1Dim_c v1d;
-	switch( orient )
-	{
-		case OR_ROW: v1d = GetView( OR_ROW, row ); break;
-		case OR_COL: v1d = GetView( OR_COL, col ); break;
-		case OR_BLK: v1d = GetView( OR_BLK, GetBlockIndex(row,col) ); break;
-		default: assert(0);
-	}
-//std::cout << "GetOtherCells(" << GetString(orient) << "): 1st cell pos=" << v1d.GetCell(0)._pos << '\n';
-	for( index_t i=0; i<9; i++ )  // for each cell of the view
-	{
-		const Cell& c = v1d.GetCell( i );
-		if( c.GetPos() != src.GetPos() )
-		{
-			switch( goc_mode )
-			{
-				case GOCM_NB_CAND:
-					if( c.NbCandidates() == arg )
-						out.push_back( c.GetPos() );
-				break;
-				case GOCM_CAND_VALUE:
-					if( c.HasCandidate( arg ) )
-						out.push_back( c.GetPos() );
-				break;
-				default: assert(0);
-			}
-		}
-	}
+	CellSet out;
+	for( index_t i=0; i<81; i++ )
+		if( getCell(i).HasCandidate( val ) )
+			out.set( i );
 	return out;
 }
-
-//----------------------------------------------------------------------------
-/// Returns a set of cell positions that are on same row/col/block as \c src and have candidate \c cand
-std::vector<pos_t>
-Grid::GetOtherCells_cand( const Cell& src, int cand, EN_ORIENTATION orient ) const
-{
-	return GetOtherCells( src, cand, orient, GOCM_CAND_VALUE );
-}
-//----------------------------------------------------------------------------
-/// Returns a set of cell positions that are on same row/col/block as \c src and have \c nb candidates
-std::vector<pos_t>
-Grid::GetOtherCells_nbc( const Cell& src, int nbc, EN_ORIENTATION orient ) const
-{
-	return GetOtherCells( src, nbc, orient, GOCM_NB_CAND );
-}
 //----------------------------------------------------------------------------
 int
 Grid::NbUnknows() const
@@ -528,20 +705,36 @@ Grid::NbUnknows() const
 bool
 Grid::ProcessAlgorithm( EN_ALGO algo )
 {
+	ALLOC_PHASE( algo );
 	bool res = false;
 	switch( algo )
 	{
 		case ALG_REMOVE_CAND:    res = Algo_RemoveCandidates( *this );     break;
 		case ALG_SEARCH_PAIRS:   res = Algo_SearchNakedPairs( *this );     break;
 		case ALG_SEARCH_TRIPLES: res = Algo_SearchNakedTriples( *this );   break;
+		case ALG_SEARCH_QUADS:   res = Algo_SearchNakedQuads( *this );     break;
 		case ALG_SEARCH_SINGLE_CAND: res = Algo_SearchSingleCand( *this ); break;
 		case ALG_SEARCH_MISSING_SINGLE: res = Algo_SearchSingleMissing( *this ); break;
 		case ALG_POINTING_PT:    res = Algo_PointingPairsTriples( *this ); break;
 		case ALG_BOX_RED:        res = Algo_BoxReduction( *this ); break;
+		case ALG_HIDDEN_PAIRS:   res = Algo_SearchHiddenPairs( *this ); break;
+		case ALG_HIDDEN_TRIPLES: res = Algo_SearchHiddenTriples( *this ); break;
+		case ALG_HIDDEN_QUADS:   res = Algo_SearchHiddenQuads( *this ); break;
+		case ALG_X_WING:         res = Algo_X_Wing( *this ); break;
+		case ALG_SWORDFISH:      res = Algo_Swordfish( *this ); break;
+		case ALG_JELLYFISH:      res = Algo_Jellyfish( *this ); break;
 		case ALG_XY_WING:        res = Algo_XY_Wing( *this ); break;
+		case ALG_XYZ_WING:       res = Algo_XYZ_Wing( *this ); break;
+		case ALG_W_WING:         res = Algo_W_Wing( *this ); break;
+		case ALG_COLORING:       res = Algo_Coloring( *this ); break;
+		case ALG_MEDUSA:         res = Algo_Medusa( *this ); break;
+		case ALG_ALS_XZ:         res = Algo_ALS_XZ( *this ); break;
 #ifndef BUILD_WITHOUT_UDGCD
 		case ALG_X_CYCLES:       res = X_Cycles( *this ); break;
 #endif
+		case ALG_AIC:            res = Algo_AIC( *this ); break;
+		case ALG_PATTERN_OVERLAY: res = Algo_PatternOverlay( *this ); break;
+		case ALG_FORCING:        res = Algo_Forcing( *this ); break;
 		default: assert(0);
 	}
 //	SearchSingles();
@@ -549,9 +742,33 @@ Grid::ProcessAlgorithm( EN_ALGO algo )
 	return res;
 }
 //----------------------------------------------------------------------------
+/// Runs the algorithms until the grid is solved, or until none of them makes any progress
+/**
+Also stops as soon as a contradiction is found (see InitStatus() and GetStatus()), so that an invalid grid
+does not go through all the algorithms before failing.
+*/
 bool
 Grid::Solve()
 {
+	ALLOC_PHASE( AP_SOLVE );
+	InitStatus();
+	if( _status._contradiction != CO_None )
+		return false;
+	if( g_data.useOracle )
+	{
+		auto s = TakeSnapshot( *this );
+		auto nbSol = CountSolutions( s, 2 );
+		if( nbSol == 0 )
+		{
+			COUT( "no solution found for oracle" );
+			return false;
+		}
+		if( nbSol == 1 )
+			SetSolution( s._values );
+		else                                     // a valid removal could then be reported as wrong
+			std::cout << "Warning: grid has several solutions, oracle is not used\n";
+	}
+
 	int iter=0;
 	int nu_before = NbUnknows();
 	int nu_after = nu_before;
@@ -568,15 +785,23 @@ Grid::Solve()
 		do
 		{
 			res = ProcessAlgorithm( algo );
+			if( _status._contradiction != CO_None )
+			{
+				COUT( "contradiction found after algo " << GetString(algo) << ": " << GetString( _status._contradiction ) );
+				return false;
+			}
 			nu_after = NbUnknows();
 //			std::cout << "  -loop 2: algo " << algo << "-" << GetString(algo) << ": res=" << res <<  ", nb unknowns left=" << nu_after << "\n";
 
 			if( res )
 			{
-				if( g_data.Verbose )
+				if( IsVerbose() )
 					PrintAll( std::cout, "iter " + std::to_string(iter) + ": after algo " + GetString(algo)  );
-				if( g_data.doChecking )
-					assert( Check() );
+				if( g_data.doChecking && !CheckChanges() )      // sets the contradiction found
+				{
+					COUT( "checking failed after algo " << GetString(algo) );
+					return false;
+				}
 			}
 
 			if( !res )                                                       // if no changes happened, then switch to next algorithm
@@ -610,6 +835,98 @@ Grid::Solve()
 
 	return( nu_after == 0 );
 }
+//----------------------------------------------------------------------------
+/// Returns the first deduction that can be made on the current grid, the algorithms being tried in the order of EN_ALGO
+/**
+This is the order used by Solve(), the cheapest ones first.
+The algorithms run on a copy of the grid, that records its changes (see ChangeRecord): the grid is only updated
+if \c apply is true and a hint is found. The copy uses the caches and storages of the grid (see SwapStorage()).
+The algorithm that finds something completes its pass, so the hint holds all its removals and assignments,
+the first one being detailed.
+
+If the grid is found invalid, by an algorithm or before, no hint is returned and the contradiction is given in the hint.
+
+Nothing is printed or logged by the calling thread, whatever the options (see QuietOutput),
+and the steps are only added to \c g_data.NbSteps if the hint is applied.
+The status of the grid is only computed if it is not up to date, so that successive calls are cheap.
+*/
+Hint
+Grid::FindHint( bool apply )
+{
+	QuietOutput quiet;
+	Hint hint;
+	if( !_status._upToDate )
+		InitStatus();
+	if( _status._contradiction != CO_None )
+	{
+		hint._contradiction = _status._contradiction;
+		hint._where = _status._where;
+		return hint;
+	}
+	if( NbUnknows() == 0 )
+		return hint;
+
+	Grid g( *this );
+	g.SwapStorage( *this );
+	g._status._record = &hint._changes;
+	for( int a=0; a<ALG_END; a++ )
+	{
+		bool found = g.ProcessAlgorithm( static_cast<EN_ALGO>(a) );
+		if( g._status._contradiction != CO_None )       // an algorithm may flag it and return false
+		{
+			hint._contradiction = g._status._contradiction;
+			hint._where = g._status._where;
+			break;
+		}
+		if( found )
+		{
+			hint._algo = static_cast<EN_ALGO>(a);
+			break;
+		}
+	}
+	g._status._record = nullptr;
+	g.SwapStorage( *this );
+
+	if( hint._contradiction != CO_None )
+		hint._changes = ChangeRecord();            // built on an invalid grid
+	else
+		if( apply && hint.Found() )
+		{
+			*this = g;
+			g_data.NbSteps += hint._changes._nbSteps;
+		}
+	return hint;
+}
+//----------------------------------------------------------------------------
+/// Exchanges the caches and storages of the algorithms with grid \c other, see FindHint()
+/**
+They can be used by any grid (see XCyclesCache), so a copy can work with those of the original one.
+*/
+void
+Grid::SwapStorage( Grid& other )
+{
+	std::swap( _xcCache,  other._xcCache );
+	std::swap( _aicGraph, other._aicGraph );
+	std::swap( _alsIndex, other._alsIndex );
+}
+//----------------------------------------------------------------------------
+/// Streams the hint \c h on \c s, as "algorithm: first change because reason (values changed, nb of cells changed)"
+std::ostream&
+operator << ( std::ostream& s, const Hint& h )
+{
+	if( h._contradiction != CO_None )
+		return s << "no hint, grid is invalid: " << GetString( h._contradiction );
+	if( !h.Found() )
+		return s << "no hint found";
+
+	const auto& ch = h._changes;
+	s << GetString( h._algo ) << ": " << GetPosFromCellIndex( ch._cell ) << ( ch._firstIsPlaced ? '=' : '-' ) << (int)ch._value;
+	if( ch._because._bt != B_noReason )
+		s << " because " << ch._because.getString();
+	s << " (values " << ch._digits << ", removals in " << ch._removed.count() << " cells, "
+		<< ch._placed.count() << " cells assigned)";
+	return s;
+}
 
 //----------------------------------------------------------------------------
 Viewtable
@@ -32,13 +32,14 @@
 #define HG_GRID_H
 
 #include <array>
+#include <bitset>
 #include <sstream>
 #include <vector>
-#include <map>
 #include <algorithm>
 #include <iostream>
 #include <cassert>
 #include <type_traits>
+#include <memory>
 
 #include "header.h"
 
@@ -54,12 +55,6 @@ using pos_t = std::pair<index_t,index_t>;
 /// a pair of (linked) positions
 using pospair_t = std::pair<pos_t,pos_t>;
 
-/// each cell has such a map with 9 values, to hold candidates with true/false value
-using cand_map_t=std::map<value_t,bool>;
-
-struct Cell;
-void LogStep( int level, const Cell& cell, std::string msg );
-
 /*
 #ifdef NDEBUG
 	#define ASSERT_1( a, b ) ;
@@ -86,60 +81,129 @@ struct GlobData
 #endif
 	int  NbSteps  = 0;
 	bool doChecking = false;
+	bool useOracle = false;        ///< check each removal against the solution, see option \c -o and GridStatus::SetSolution()
 	bool stopAfterFirstFound = false;
+	int  nbThreads = 1;            ///< nb of threads used by X-cycles search and forcing chains, see option \c -j
+	bool xcyclesBatch = false;     ///< X-cycles: apply eliminations of all cycles at once, see option \c -b
+	size_t xcMaxCycleLength = 12;  ///< X-cycles: maximum length of the cycles searched (nb of cells)
+	size_t xcMaxCycles = 2000;     ///< X-cycles: maximum nb of valid cycles searched for a given value
+	size_t xcMaxVisits = 50000;    ///< X-cycles: maximum nb of vertices visited by the cycles search, for a given value
+	size_t aicMaxDepth = 16;       ///< AIC: maximum length of the chains (nb of links)
 };
 extern GlobData g_data;
 
 //----------------------------------------------------------------------------
-/// Candidate Map
-struct CandMap
+/// Silences the calling thread while in scope, whatever the options of \c g_data. See Grid::FindHint()
+/**
+The options are left untouched, so the other threads are not affected, and the previous state is restored even on exception.
+*/
+class QuietOutput
+{
+	public:
+		QuietOutput(): _prev( s_quiet ) { s_quiet = true; }
+		~QuietOutput() { s_quiet = _prev; }
+		QuietOutput( const QuietOutput& ) = delete;
+		QuietOutput& operator = ( const QuietOutput& ) = delete;
+		static bool IsOn() { return s_quiet; }
+
+	private:
+		bool _prev;
+		static thread_local bool s_quiet;
+};
+
+/// True if the debug messages are printed by the calling thread, see option \c -v
+inline bool IsVerbose() { return g_data.Verbose && !QuietOutput::IsOn(); }
+/// Level of the steps logged by the calling thread, see option \c -l
+inline int  LogLevel()  { return QuietOutput::IsOn() ? 0 : g_data.LogSteps; }
+
+//----------------------------------------------------------------------------
+/// A set of candidate values, stored as a 9-bit mask: bit \c i is set if value \c i+1 is in the set
+/**
+Same encoding as Cell::GetCandMask(), but with a value type interface. Never allocates, so can be used in the inner loops.
+Iterating gives the values of the set, in increasing order:
+\code
+for( auto v: cell.GetCandidates() )
+	...
+\endcode
+*/
+struct CandSet
 {
-	CandMap()
+/// Iterates over the values of a CandSet
+	struct Iterator
 	{
-		for( value_t i=1; i<10; i++ )
-			cmap[i]=true;
-	}
-	bool Has( value_t cand )
+		uint16_t _mask;  ///< values not yet visited
+
+		value_t operator * () const
+		{
+			value_t v = 1;
+			while( !( _mask & (1<<(v-1)) ) )
+				v++;
+			return v;
+		}
+		Iterator& operator ++ ()
+		{
+			_mask &= _mask - 1;      // clear lowest set bit
+			return *this;
+		}
+		bool operator != ( const Iterator& it ) const
+		{
+			return _mask != it._mask;
+		}
+	};
+
+	CandSet() = default;
+	explicit CandSet( uint16_t mask ): _mask( mask & 0x1ff )
+	{}
+/// Returns a set holding the 9 values
+	static CandSet All() { return CandSet( 0x1ff ); }
+
+	bool Has( value_t v ) const
 	{
-		return cmap[cand];
+		assert( v>0 && v<10 );
+		return _mask & (1<<(v-1));
 	}
-	void Remove( value_t cand )
+	void Add( value_t v )
 	{
-		cmap[cand] = false;
+		assert( v>0 && v<10 );
+		_mask |= 1<<(v-1);
 	}
-
-	const bool& operator [] ( const value_t& v ) const
+	void Remove( value_t v )
 	{
-		return cmap.at(v);
+		assert( v>0 && v<10 );
+		_mask &= ~(1<<(v-1));
 	}
+	uint16_t Mask()  const { return _mask; }
+	bool     Empty() const { return _mask == 0; }
+	uint8_t  Size()  const { return std::bitset<9>( _mask ).count(); }
 
-	bool& operator [] ( const value_t& v )
-	{
-		return cmap[v];
-	}
+	Iterator begin() const { return Iterator{ _mask }; }
+	Iterator end()   const { return Iterator{ 0 }; }
 
-	private:
-		std::map<value_t,bool> cmap;
-};
-//----------------------------------------------------------------------------
-/// Return type of SearchTriplesPattern(). Holds the naked triples values and positions in the row/col/block
-struct NakedTriple
-{
-	bool found_NT = false;
-	std::array<value_t,3> cand_values;
-	std::array<index_t,3> cand_pos;
-	void foundPattern() { found_NT = true; }
+	bool operator == ( const CandSet& cs ) const { return _mask == cs._mask; }
+	bool operator != ( const CandSet& cs ) const { return _mask != cs._mask; }
+
+/// Intersection
+	CandSet operator & ( const CandSet& cs ) const { return CandSet( _mask & cs._mask ); }
+/// Union
+	CandSet operator | ( const CandSet& cs ) const { return CandSet( _mask | cs._mask ); }
+	CandSet& operator &= ( const CandSet& cs ) { _mask &= cs._mask; return *this; }
+	CandSet& operator |= ( const CandSet& cs ) { _mask |= cs._mask; return *this; }
 
-	friend std::ostream& operator << ( std::ostream& s, const NakedTriple& nt )
+	friend std::ostream& operator << ( std::ostream& s, const CandSet& cs )
 	{
-//		s << "NakedTriple: found=" << std::boolalpha << nt.found_NT;
-		if( nt.found_NT )
-			s << '(' << (int)nt.cand_values[0] << '-' << (int)nt.cand_values[1] << '-' << (int)nt.cand_values[2] << ')';
-		else
-			s << "(--NONE!--)";
-//		s << '\n';
+		s << '{';
+		bool first = true;
+		for( auto v: cs )
+		{
+			s << (first ? "" : ",") << (int)v;
+			first = false;
+		}
+		s << '}';
 		return s;
 	}
+
+	private:
+		uint16_t _mask = 0;
 };
 
 //----------------------------------------------------------------------------
@@ -192,6 +256,190 @@ getPosFromBlockIndex(
 	pos.second += idx%3;
 	return pos;
 }
+
+/// Returns index of cell in the grid [0-80] from position (row,col)
+/** See opposite: GetPosFromCellIndex(), and Grid::getCell() */
+inline
+index_t
+GetCellIndex( pos_t p )
+{
+	return p.first*9 + p.second;
+}
+
+/// Returns position of cell from its index in the grid [0-80]
+/** See opposite: GetCellIndex() */
+inline
+pos_t
+GetPosFromCellIndex( index_t idx )
+{
+	return pos_t( idx/9, idx%9 );
+}
+
+/// Returns the value of a candidate mask holding a single value, see Cell::GetCandMask()
+inline
+value_t
+GetMaskValue( uint16_t mask )
+{
+	assert( std::bitset<9>( mask ).count() == 1 );
+	value_t v = 1;
+	while( !( mask & (1<<(v-1)) ) )
+		v++;
+	return v;
+}
+
+//----------------------------------------------------------------------------
+/// A set of cells of the grid, as a 81-bit mask indexed by GetCellIndex()
+/**
+Stored as two 64-bit words: the set operations and the counting are a few instructions, and never allocate.
+Same interface as the \c std::bitset<81> it replaces, plus iteration over the indexes of the cells of the set,
+in increasing order:
+\code
+for( auto c: cells )
+	...
+\endcode
+*/
+struct CellSet
+{
+/// Iterates over the cell indexes of a CellSet
+	struct Iterator
+	{
+		uint64_t _w0, _w1;  ///< cells not yet visited
+
+		index_t operator * () const
+		{
+			return _w0 ? LowestBit( _w0 ) : 64 + LowestBit( _w1 );
+		}
+		Iterator& operator ++ ()
+		{
+			if( _w0 )
+				_w0 &= _w0 - 1;      // clear lowest set bit
+			else
+				_w1 &= _w1 - 1;
+			return *this;
+		}
+		bool operator != ( const Iterator& it ) const
+		{
+			return _w0 != it._w0 || _w1 != it._w1;
+		}
+	};
+
+	CellSet()
+	{}
+/// Builds the set from the cells 0 to 63
+	explicit CellSet( uint64_t w0 ): _w0( w0 )
+	{}
+
+	bool test( index_t c ) const
+	{
+		assert( c < 81 );
+		return c < 64 ? ( _w0 >> c ) & 1 : ( _w1 >> (c-64) ) & 1;
+	}
+	bool operator [] ( index_t c ) const
+	{
+		return test( c );
+	}
+	CellSet& set( index_t c )
+	{
+		assert( c < 81 );
+		if( c < 64 )
+			_w0 |= uint64_t(1) << c;
+		else
+			_w1 |= uint64_t(1) << (c-64);
+		return *this;
+	}
+/// Sets all the cells
+	CellSet& set()
+	{
+		_w0 = ~uint64_t(0);
+		_w1 = W1_MASK;
+		return *this;
+	}
+	CellSet& reset( index_t c )
+	{
+		assert( c < 81 );
+		if( c < 64 )
+			_w0 &= ~( uint64_t(1) << c );
+		else
+			_w1 &= ~( uint64_t(1) << (c-64) );
+		return *this;
+	}
+	CellSet& reset()
+	{
+		_w0 = _w1 = 0;
+		return *this;
+	}
+	size_t count() const
+	{
+		return PopCount( _w0 ) + PopCount( _w1 );
+	}
+	bool any()  const { return _w0 || _w1; }
+	bool none() const { return !any(); }
+
+	Iterator begin() const { return Iterator{ _w0, _w1 }; }
+	Iterator end()   const { return Iterator{ 0, 0 }; }
+
+	CellSet operator & ( const CellSet& cs ) const { return CellSet( _w0 & cs._w0, _w1 & cs._w1 ); }
+	CellSet operator | ( const CellSet& cs ) const { return CellSet( _w0 | cs._w0, _w1 | cs._w1 ); }
+	CellSet operator ^ ( const CellSet& cs ) const { return CellSet( _w0 ^ cs._w0, _w1 ^ cs._w1 ); }
+	CellSet operator ~ () const                    { return CellSet( ~_w0, ~_w1 & W1_MASK ); }
+	CellSet& operator &= ( const CellSet& cs ) { _w0 &= cs._w0; _w1 &= cs._w1; return *this; }
+	CellSet& operator |= ( const CellSet& cs ) { _w0 |= cs._w0; _w1 |= cs._w1; return *this; }
+	CellSet& operator ^= ( const CellSet& cs ) { _w0 ^= cs._w0; _w1 ^= cs._w1; return *this; }
+
+	bool operator == ( const CellSet& cs ) const { return _w0 == cs._w0 && _w1 == cs._w1; }
+	bool operator != ( const CellSet& cs ) const { return !( *this == cs ); }
+
+	private:
+		static const uint64_t W1_MASK = ( uint64_t(1) << (81-64) ) - 1;   ///< the 17 valid bits of the second word
+
+		CellSet( uint64_t w0, uint64_t w1 ): _w0( w0 ), _w1( w1 )
+		{}
+		static size_t PopCount( uint64_t w )
+		{
+#ifdef __GNUC__
+			return __builtin_popcountll( w );
+#else
+			return std::bitset<64>( w ).count();
+#endif
+		}
+		static index_t LowestBit( uint64_t w )
+		{
+			assert( w != 0 );
+#ifdef __GNUC__
+			return __builtin_ctzll( w );
+#else
+			index_t i = 0;
+			while( !( ( w >> i ) & 1 ) )
+				i++;
+			return i;
+#endif
+		}
+
+		uint64_t _w0 = 0;  ///< cells 0 to 63
+		uint64_t _w1 = 0;  ///< cells 64 to 80
+};
+
+/// Cell indexes of the 27 units: rows are units 0-8, cols 9-17, blocks 18-26. See GetUnitsTable()
+using UnitsTable = std::array<std::array<index_t,9>,27>;
+
+/// Cell indexes of the 20 other cells sharing a row, a col or a block with each cell. See GetPeersTable()
+using PeersTable = std::array<std::array<index_t,20>,81>;
+
+/// Same as \c PeersTable, but as 81-bit masks, indexed by GetCellIndex(). See GetPeerMasks()
+using PeerMasks = std::array<CellSet,81>;
+
+const UnitsTable& GetUnitsTable();
+const PeersTable& GetPeersTable();
+const PeerMasks&  GetPeerMasks();
+
+/// The strong links (conjugate pairs) of a value, as pairs of cell indexes: at most one per unit. See GetStrongLinks()
+struct StrongLinks
+{
+	std::array<std::pair<index_t,index_t>,27> _links;
+	index_t _nb = 0;
+};
+
+StrongLinks GetStrongLinks( const CellSet& board );
 //----------------------------------------------------------------------------
 inline
 char
@@ -211,15 +459,50 @@ std::ostream& operator << ( std::ostream& s, const pos_t& p )
 	return s;
 }
 
+//----------------------------------------------------------------------------
+/// Kind of contradiction found while solving, see \c GridStatus
+enum EN_CONTRADICTION
+{
+	CO_None
+	,CO_EmptyCell        ///< a cell has no value and no candidate left
+	,CO_MissingValue     ///< a value has no place left in a row/col/block
+	,CO_DuplicateValue   ///< a value is assigned twice in a row/col/block
+	,CO_WrongRemoval     ///< the solution value of a cell has been removed, see GridStatus::SetSolution()
+	,CO_WrongAssignment  ///< a cell has been assigned a value that is not its solution value, see GridStatus::SetSolution()
+	,CO_TwoValues        ///< a cell is the only place left for two values
+	,CO_Propagation      ///< placing the singles leads to a contradiction, see PropagateSingles()
+	,CO_StaleStatus      ///< the status of a row/col/block does not match the grid, see Grid::CheckChanges()
+};
+
+inline
+const char*
+GetString( EN_CONTRADICTION co )
+{
+	switch( co )
+	{
+		case CO_None:           return "none"; break;
+		case CO_EmptyCell:      return "empty cell"; break;
+		case CO_MissingValue:   return "missing value"; break;
+		case CO_DuplicateValue: return "duplicate value"; break;
+		case CO_WrongRemoval:   return "removal of solution value"; break;
+		case CO_WrongAssignment:return "assignment of wrong value"; break;
+		case CO_TwoValues:      return "only place for two values"; break;
+		case CO_Propagation:    return "singles propagation"; break;
+		case CO_StaleStatus:    return "status not up to date"; break;
+		default: assert(0);
+	}
+}
 //----------------------------------------------------------------------------
 /// Reason to remove a candidate, see \c Because
 enum BecauseType
 {
 	B_noReason
 	,B_ValuePresent
-	,B_NakedTriples
 	,B_PointingPairsTriples
-	,B_NakedPair
+	,B_BoxReduction
+	,B_NakedSubset
+	,B_HiddenSubset
+	,B_Fish
 };
 
 /// Holds explanation of why we remove a candidate
@@ -230,12 +513,8 @@ struct Because
 		: _bt(bt), _orient( orient )
 	{}
 
-	Because( BecauseType bt, EN_ORIENTATION orient, NakedTriple tp )
-		: _bt(bt), _orient( orient ), _nakedTriple(tp)
-	{}
-
-	Because( BecauseType bt, const std::vector<value_t>& np, EN_ORIENTATION orient )
-		: _bt(bt), _np(np), _orient( orient )
+	Because( BecauseType bt, uint16_t candMask, EN_ORIENTATION orient )
+		: _bt(bt), _candMask(candMask), _orient( orient )
 	{}
 	Because( BecauseType bt, index_t idx1, index_t idx2, EN_ORIENTATION orient )
 		: _bt(bt), _idx1(idx1), _idx2(idx2), _orient( orient )
@@ -263,16 +542,38 @@ struct Because
 			}
 			break;
 
-			case B_NakedTriples:
-				oss << "Naked Triples in " << GetString( _orient ) << ": " << _nakedTriple;
-			break;
-
 			case B_PointingPairsTriples:
 				oss << "Pointing Pairs or Triples in " << GetString( _orient );
 			break;
 
-			case B_NakedPair:
-				oss << "Naked pair (" << (int)_np[0] << '-' << (int)_np[1] << ") in " << GetString( _orient );
+			case B_BoxReduction:
+				oss << "Box Reduction in " << GetString( _orient );
+			break;
+
+			case B_NakedSubset:
+			case B_HiddenSubset:
+			{
+				const char* names[] = { "pair", "triple", "quad" };
+				auto n = std::bitset<9>( _candMask ).count();
+				assert( n>=2 && n<=4 );
+				oss << ( _bt == B_NakedSubset ? "Naked " : "Hidden " ) << names[n-2] << " (";
+				for( value_t v=1; v<10; v++ )
+					if( _candMask & (1<<(v-1)) )
+					{
+						oss << (int)v;
+						if( --n )
+							oss << '-';
+					}
+				oss << ") in " << GetString( _orient );
+			}
+			break;
+
+			case B_Fish:
+			{
+				const char* names[] = { "X-Wing", "Swordfish", "Jellyfish" };
+				assert( _idx1>=2 && _idx1<=4 );
+				oss << names[_idx1-2] << " on value " << (int)_idx2 << ", base lines: " << GetString( _orient );
+			}
 			break;
 
 			case B_noReason: break;
@@ -283,11 +584,120 @@ struct Because
 	BecauseType    _bt = B_noReason;
 	index_t        _idx1;
 	index_t        _idx2;
-	std::vector<value_t> _np;    ///< holds naked pair
+	uint16_t       _candMask = 0;  ///< candidates of the naked/hidden subset, see Cell::GetCandMask()
 	EN_ORIENTATION _orient = OR_INVALID;
-	NakedTriple    _nakedTriple;
 };
 
+//----------------------------------------------------------------------------
+/// Changes made to the grid, recorded by GridStatus when asked to (see Grid::FindHint())
+struct ChangeRecord
+{
+	CellSet  _removed;       ///< cells having lost some candidates
+	CellSet  _placed;        ///< cells that were assigned a value
+	CandSet  _digits;        ///< values removed or assigned
+	bool     _any = false;   ///< true if something changed, the fields below are then valid
+	index_t  _cell  = 0;     ///< first cell changed, see GetCellIndex()
+	value_t  _value = 0;     ///< value removed from that cell, or assigned to it if \c _firstIsPlaced
+	bool     _firstIsPlaced = false;
+	Because  _because;       ///< reason of the first removal, if the algorithm gives one
+	int      _nbSteps = 0;   ///< nb of steps made, counted here instead of in \c g_data (see LogStep())
+
+	void Add( index_t cell, value_t val, bool placed, const Because& bec )
+	{
+		if( !_any )
+		{
+			_any   = true;
+			_cell  = cell;
+			_value = val;
+			_firstIsPlaced = placed;
+			_because = bec;
+		}
+		if( placed )
+			_placed.set( cell );
+		else
+			_removed.set( cell );
+		_digits.Add( val );
+	}
+};
+
+//----------------------------------------------------------------------------
+/// Contradiction flag of a grid, kept up to date by the cells each time a candidate is removed or a value assigned
+/**
+For each row/col/block (see GetUnitsTable()) and each value, we count the cells holding that value as candidate or value,
+and keep the mask of the assigned values, so that each update is O(1). See Grid::InitStatus()
+
+The units changed are also recorded, so that Grid::CheckChanges() only needs to check these ones.
+If a solution has been given (see SetSolution()), each removal is also checked against it.
+*/
+struct GridStatus
+{
+	std::array<std::array<uint8_t,9>,27> _places;   ///< for each unit and value, nb of cells holding it as candidate or value
+	std::array<uint16_t,27>               _placed;   ///< for each unit, the assigned values, as a 9-bit mask
+	EN_CONTRADICTION _contradiction = CO_None;        ///< first contradiction found
+	index_t          _where = 0;                      ///< cell (CO_EmptyCell, CO_WrongRemoval, CO_WrongAssignment, CO_TwoValues) or unit index where it was found
+	uint32_t         _changed = 0;                    ///< units changed since last check, one bit per unit
+	bool             _hasSolution = false;
+	std::array<value_t,81> _solution;                ///< solution used as oracle, if \c _hasSolution
+	ChangeRecord*    _record = nullptr;               ///< if not null, the changes are recorded in it
+	bool             _upToDate = false;               ///< set by Grid::InitStatus(), cleared when the grid is loaded
+
+	void SetSolution( const std::array<value_t,81>& sol )
+	{
+		_solution = sol;
+		_hasSolution = true;
+	}
+
+	void SetContradiction( EN_CONTRADICTION co, index_t where )
+	{
+		if( _contradiction == CO_None )
+		{
+			_contradiction = co;
+			_where = where;
+		}
+	}
+/// The 3 units of a cell: row, col, block
+	static std::array<index_t,3> GetUnits( pos_t pos )
+	{
+		return { { pos.first, index_t(9+pos.second), index_t(18+GetBlockIndex( pos )) } };
+	}
+/// Called when candidate \c val is removed from cell at position \c pos (and is not its value)
+	void OnRemoved( pos_t pos, value_t val, const Because& bec=Because() )
+	{
+		if( _record )
+			_record->Add( GetCellIndex( pos ), val, false, bec );
+		if( _hasSolution && _solution[ GetCellIndex( pos ) ] == val )
+			SetContradiction( CO_WrongRemoval, GetCellIndex( pos ) );
+		for( auto u: GetUnits( pos ) )
+		{
+			_changed |= 1 << u;
+			if( --_places[u][val-1] == 0 )
+				SetContradiction( CO_MissingValue, u );
+		}
+	}
+/// Called when value \c val is assigned to cell at position \c pos, \c wasCandidate tells if it was one of its candidates
+	void OnAssigned( pos_t pos, value_t val, bool wasCandidate )
+	{
+		if( _record )
+			_record->Add( GetCellIndex( pos ), val, true, Because() );
+		if( _hasSolution && _solution[ GetCellIndex( pos ) ] != val )
+			SetContradiction( CO_WrongAssignment, GetCellIndex( pos ) );
+		uint16_t bit = 1 << (val-1);
+		for( auto u: GetUnits( pos ) )
+		{
+			_changed |= 1 << u;
+			if( !wasCandidate )
+				_places[u][val-1]++;
+			if( _placed[u] & bit )
+				SetContradiction( CO_DuplicateValue, u );
+			_placed[u] |= bit;
+		}
+	}
+};
+
+
+
+struct Cell;
+void LogStep( int level, const Cell& cell, const char* action, value_t val, const Because& bec=Because() );
 
 //----------------------------------------------------------------------------
 /// Holds a cell, has either a value, either a set of candidates (in which case the value is 0)
@@ -301,12 +711,20 @@ struct Cell
 
 	private:
 	value_t   _value = 0;  ///< Cell value
-	CandMap   _cand;       ///< Candidate map
+	CandSet   _cand = CandSet::All();  ///< Candidates
 	pos_t     _pos;        ///< Position in view [0-8]
+	GridStatus* _status = nullptr;  ///< status of the grid holding the cell, updated on each change. See Grid::InitStatus()
 
 	public:
 	value_t GetValue() const { return _value; }
-	void SetValue( value_t v ) { _value = v; }
+	void SetValue( value_t v )
+	{
+		if( _status && v != 0 )
+			_status->OnAssigned( _pos, v, _cand.Has( v ) );
+		_value = v;
+	}
+	void SetStatus( GridStatus* status ) { _status = status; }
+	ChangeRecord* GetRecord() const { return _status ? _status->_record : nullptr; }
 
 	void SetPos( index_t i, index_t j )
 	{
@@ -317,26 +735,26 @@ struct Cell
 
 	void PrintCellCandidates( std::ostream& s )
 	{
-		bool found = false;
-		for( value_t i=1; i<10; i++ )
-			if( _cand[i] )
-			{
-				s << (int)i << ",";
-				found = true;
-			}
-		if( !found )
+		for( auto v: _cand )
+			s << (int)v << ",";
+		if( _cand.Empty() )
 			s << "(none)";
 		s << '\n';
 	}
 	void RemoveAllCandidates()
 	{
-		for( value_t i=1; i<10; i++ )
-			_cand[i] = false;
+		if( _status )
+			for( auto v: _cand )
+				if( v != _value )
+					_status->OnRemoved( _pos, v );
+		_cand = CandSet();
+		if( _status && _value == 0 )
+			_status->SetContradiction( CO_EmptyCell, GetCellIndex( _pos ) );
 	}
-	bool RemoveCellCandidates( std::vector<value_t> v_cand, Because bec=Because() )
+	bool RemoveCellCandidates( CandSet cands, Because bec=Because() )
 	{
 		bool b = false;
-		for( auto v: v_cand )
+		for( auto v: cands )
 		{
 			bool b1 = RemoveCandidate( v, bec );
 			if( b1 )
@@ -347,23 +765,36 @@ struct Cell
 /// Remove candidate \c val in the cell, returns true if the cell did hold that value as candidate, false if not
 	bool RemoveCandidate( value_t val, Because bec=Because() )
 	{
-		if( _cand[val] )
+		if( _cand.Has( val ) )
 		{
-			if( bec._bt != B_noReason )
-				LogStep( 2, *this, "remove candidate " + std::to_string(val) + " because " + bec.getString() );
-			else
-				LogStep( 2, *this, "remove candidate " + std::to_string(val) );
-			_cand[val] = false;
-			if( NbCandidates() == 1 )
+			LogStep( 2, *this, "remove candidate", val, bec );
+			_cand.Remove( val );
+			if( _status )
+				_status->OnRemoved( _pos, val, bec );
+			auto nb = NbCandidates();
+			if( nb == 1 )
 			{
 				_value = GetValueFromCandidate();
-				_cand[_value] = false;
-				LogStep( 1, *this, "assign value " + std::to_string(_value) );
+				if( _status )
+					_status->OnAssigned( _pos, _value, true );
+				LogStep( 1, *this, "assign value", _value );
 			}
+			if( nb == 0 && _value == 0 && _status )
+				_status->SetContradiction( CO_EmptyCell, GetCellIndex( _pos ) );
 			return true;
 		}
 		return false;
 	}
+/// Remove the candidates set in \c candMask (see GetCandMask()), returns true if at least one was removed
+	bool RemoveCandidates( uint16_t candMask, Because bec=Because() )
+	{
+		bool b = false;
+		for( value_t v=1; v<10 && _value==0; v++ )
+			if( candMask & (1<<(v-1)) )
+				if( RemoveCandidate( v, bec ) )
+					b = true;
+		return b;
+	}
 
 	bool RemoveAllCandidatesBut( value_t val )
 	{
@@ -374,39 +805,30 @@ struct Cell
 					removalDone = true;
 		return removalDone;
 	}
-	std::vector<value_t> GetCandidates() const
+	CandSet GetCandidates() const
 	{
-		std::vector<value_t> v;
-		for( value_t i=1; i<10; i++ )
-			if( _cand[i] )
-				v.push_back( i );
-		return v;
+		return _cand;
+	}
+/// Returns the candidates as a 9-bit mask: bit \c i is set if value \c i+1 is a candidate
+	uint16_t GetCandMask() const
+	{
+		return _cand.Mask();
 	}
 	uint8_t NbCandidates() const
 	{
-		uint8_t n = 0;
-		for( value_t i=1; i<10; i++ )
-			if( _cand[i] )
-				n++;
-		return n;
+		return _cand.Size();
 	}
 	bool HasCandidate( value_t currentValue ) const
 	{
-		assert( currentValue>0 && currentValue<10 );
-		return _cand[currentValue];
+		return _cand.Has( currentValue );
 	}
 
 	value_t GetValueFromCandidate()
 	{
 		assert( NbCandidates() == 1 );
-		for( value_t i=1; i<10; i++ )
-			if( _cand[i] )
-			{
-				_cand[i] = false;
-				return i;
-			}
-		assert(0);
-		return 0; // to avoid warning
+		value_t v = *_cand.begin();
+		_cand.Remove( v );
+		return v;
 	}
 	bool IsInBlock( index_t bl ) const
 	{
@@ -467,8 +889,6 @@ PrintView( std::ostream& s, View_1Dim_nc& v )
 	s << '\n';
 }
 
-/// used in Grid::GetOtherCells()
-enum EN_GOCMODE { GOCM_NB_CAND, GOCM_CAND_VALUE };
 
 
 enum EN_ALGO
@@ -476,34 +896,45 @@ enum EN_ALGO
 	ALG_REMOVE_CAND = 0,
 	ALG_SEARCH_PAIRS,
 	ALG_SEARCH_TRIPLES,
+	ALG_SEARCH_QUADS,
 	ALG_SEARCH_SINGLE_CAND,
 	ALG_SEARCH_MISSING_SINGLE,
 	ALG_POINTING_PT,
 	ALG_BOX_RED,
+	ALG_HIDDEN_PAIRS,
+	ALG_HIDDEN_TRIPLES,
+	ALG_HIDDEN_QUADS,
+	ALG_X_WING,
+	ALG_SWORDFISH,
+	ALG_JELLYFISH,
 	ALG_XY_WING,
+	ALG_XYZ_WING,
+	ALG_W_WING,
+	ALG_COLORING,
+	ALG_MEDUSA,
+	ALG_ALS_XZ,
 #ifndef BUILD_WITHOUT_UDGCD
 	ALG_X_CYCLES,
 #endif
+	ALG_AIC,
+	ALG_PATTERN_OVERLAY,  ///< after the chains: it finds all the single-value eliminations, so they would never find anything
+	ALG_FORCING,
 	ALG_END
 };
 
 //----------------------------------------------------------------------------
-template<typename T>
-std::vector<T>
-VectorRemoveDupes( std::vector<T>& vin )
+/// A deduction, as returned by Grid::FindHint()
+struct Hint
 {
-	std::vector<T> vout;
-	for( const auto& elem: vin )
-	{
-		if( std::find( std::begin(vout), std::end(vout), elem ) ==  std::end(vout) )
-			vout.push_back( elem );
-	}
-/*	auto n = vin.size() - vout.size();
-	if( n )
-		std::cout << "VectorRemoveDupes(): REMOVED " << n << " DUPES\n";
-*/
-	return vout;
-}
+	EN_ALGO      _algo = ALG_END;  ///< algorithm that made the deduction, \c ALG_END if none did
+	ChangeRecord _changes;         ///< what it changed in the grid
+	EN_CONTRADICTION _contradiction = CO_None;  ///< if not \c CO_None, the grid is invalid and there is no hint
+	index_t          _where = 0;                ///< where the contradiction was found, see GridStatus::_where
+
+	bool Found() const { return _algo != ALG_END; }
+	friend std::ostream& operator << ( std::ostream&, const Hint& );
+};
+
 //----------------------------------------------------------------------------
 template<typename T>
 void
@@ -539,24 +970,10 @@ PrintVector( const std::vector<std::pair<T,T>>& v, std::string s )
 }*/
 
 //----------------------------------------------------------------------------
-/// Add element \c elem to vector \c v only if it is not already present
-template<typename T>
-void AddToVector( std::vector<T>& v, const T& elem )
-{
-	if( std::find( v.begin(), v.end(), elem ) == v.end() )
-	{
-//		std::cout << "  -adding elem " << elem << '\n';
-		v.push_back( elem );
-	}
-}
-//----------------------------------------------------------------------------
-/// Adds to vector \c v the elements of v2 only if they are not already present
-template<typename T>
-void AddToVector( std::vector<T>& v, const std::vector<T>& v2 )
-{
-	for( const auto& elem: v2 )
-		AddToVector( v, elem );
-}
+struct XCyclesCache;
+struct AicGraph;
+struct AlsIndex;
+
 //----------------------------------------------------------------------------
 class Grid
 {
@@ -567,8 +984,17 @@ class Grid
 		bool loadFromFile( std::string fn=std::string() );
 		bool saveToFile( std::string ) const;
 		bool Check() const;
+		bool CheckChanges();
+		Grid( const Grid& );
+		Grid& operator = ( const Grid& );
+		~Grid();
 		bool Solve();
+		Hint FindHint( bool apply=false );
 		void initCandidates();
+		void InitStatus();
+		const GridStatus& GetStatus() const { return _status; }
+		void SetContradiction( EN_CONTRADICTION co, index_t where ) { _status.SetContradiction( co, where ); }
+		void SetSolution( const std::array<value_t,81>& sol ) { _status.SetSolution( sol ); }
 //		void SetVerbose(bool b ) { _verbose = b; }
 		void PrintCandidates( std::ostream&, std::string=std::string() ) const;
 		void PrintAll( std::ostream&, std::string ) const;
@@ -580,22 +1006,27 @@ class Grid
 		View_1Dim_c  GetView( EN_ORIENTATION, index_t ) const;
 		View_1Dim_nc GetView( EN_ORIENTATION, index_t );
 
-		std::vector<pos_t> GetOtherCells_nbc(  const Cell&, int nb, EN_ORIENTATION )   const;
-		std::vector<pos_t> GetOtherCells_cand( const Cell&, int cand, EN_ORIENTATION ) const;
 
 		const Cell& getCell(index_t idx) const;
-
-	private:
-		std::vector<pos_t> GetOtherCells( const Cell&, int, EN_ORIENTATION, EN_GOCMODE ) const;
+		Cell&       getCell(index_t idx);
+		CellSet GetCandidateBoard( value_t ) const;
+		XCyclesCache& GetXCyclesCache();
+		AicGraph&     GetAicGraph();
+		AlsIndex&     GetAlsIndex();
 
 	private:
 		bool Check( EN_ORIENTATION ) const;
 
 		int  NbUnknows() const;
 		bool ProcessAlgorithm( EN_ALGO );
+		void SwapStorage( Grid& );
 
 	private:
 		std::array<std::array<Cell,9>,9> _data;
+		GridStatus _status;
+		std::unique_ptr<XCyclesCache> _xcCache;   ///< not copied: each grid builds its own, see X_Cycles()
+		std::unique_ptr<AicGraph>     _aicGraph;  ///< not copied: storage of Algo_AIC() on this grid
+		std::unique_ptr<AlsIndex>     _alsIndex;  ///< not copied: storage of Algo_ALS_XZ() on this grid
 
 		Viewtable  BuildViewtable() const;
 
@@ -619,6 +1050,16 @@ Grid::getCell( index_t idx ) const
 	auto col = idx%9;
 	return _data[row][col];
 }
+
+inline
+Cell&
+Grid::getCell( index_t idx )
+{
+	assert( idx<81 );
+	auto row = idx/9;
+	auto col = idx%9;
+	return _data[row][col];
+}
 //----------------------------------------------------------------------------
 
 inline
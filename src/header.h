@@ -30,11 +30,11 @@ and README.md
 		exit(1); \
 	}
 
-#define COUT(a) { if( g_data.Verbose ) std::cout << a << '\n'; }
+#define COUT(a) { if( IsVerbose() ) std::cout << a << '\n'; }
 
 #define PRINT_MAIN_IDX( o ) \
 	{ \
-		if( g_data.Verbose ) {\
+		if( IsVerbose() ) {\
 			std::cout << " -" << (o==OR_ROW ? "row" : (o==OR_COL?"col":"block") ) << '='; \
 			if( o==OR_ROW ) \
 				std::cout << GetRowLetter(idx); \
@@ -35,8 +35,10 @@ This file is part of https://github.com/skramm/sudoku_cpp
 
 #include "header.h"
 #include "algorithms.h"
+#include "alloc_count.h"
 
 #include <iomanip>
+#include <cstdlib>
 
 using namespace std;
 
@@ -49,6 +51,8 @@ enum ReturnValues: int
 	,RV_invalidGrid
 	,RV_solvingFailure
 	,RV_invalidSwitch
+	,RV_contradiction
+	,RV_wrongDeduction
 };
 
 /// sudoku solver program
@@ -63,8 +67,12 @@ int main( int argc, const char** argv )
 			<< "-switches:\n -s: save grid to file (human readable), and can be loaded with -f"
 			<< "\n -v: verbose\n -l: log steps"
 			<< "\n -c: enable checking of grid correctness after each step"
+			<< "\n -o: check each candidate removal against the solution (computed by brute force)"
 			<< "\n -t: list implmented algorithms and stop"
 			<< "\n -p: stop after first cell found"
+			<< "\n -n: only print the next deduction (algorithm, first change and reason) and stop"
+			<< "\n -j or -jN: use N threads (default: 3) for X-cycles search and forcing chains"
+			<< "\n -b: X-cycles: apply the eliminations of all the cycles at once"
 			<< "\n-return value:\n "
 			<< RV_success         << ": success (solved puzzle)\n "
 			<< RV_missingFile     << ": unable to read given filename (missing or format error)\n "
@@ -72,7 +80,9 @@ int main( int argc, const char** argv )
 			<< RV_missingCells    << ": invalid grid given (must be 81 characters, only digits or '.')\n "
 			<< RV_invalidGrid     << ": invalid grid\n "
 			<< RV_solvingFailure  << ": unable to solve\n "
-			<< RV_invalidSwitch   << ": invalid switch\n";
+			<< RV_invalidSwitch   << ": invalid switch\n "
+			<< RV_contradiction   << ": contradiction found while solving (grid has no solution)\n "
+			<< RV_wrongDeduction  << ": wrong deduction found by the oracle (solver error, see -o)\n";
 
 		return RV_success;
 	}
@@ -80,12 +90,14 @@ int main( int argc, const char** argv )
 	auto nbFlags = 0;
 	bool hasFileFlag = false;
 	bool saveGridToFile = false;
+	bool nextHint = false;
 
 	for( int i=1; i<argc; i++ )
 	{
 		auto arg = std::string( argv[i] );
 		if( arg == "-f" )
 		{
+			ALLOC_PHASE( AP_PARSING );
 			if( i+1 < argc )
 			{
 				if( !grid.loadFromFile( argv[i+1] ) )
@@ -118,6 +130,13 @@ int main( int argc, const char** argv )
 			cout << " -Option -c (Checking) activated\n";
 		}
 
+		if( arg == "-o" )      // checking each removal against the solution
+		{
+			nbFlags++;
+			g_data.useOracle = true;
+			cout << " -Option -o (Oracle) activated\n";
+		}
+
 		if( arg.substr(0,2) == "-l" )     // logging options
 		{
 			nbFlags++;
@@ -139,6 +158,35 @@ int main( int argc, const char** argv )
 			g_data.stopAfterFirstFound = true;
 		}
 
+		if( arg == "-n" )
+		{
+			nbFlags++;
+			nextHint = true;
+		}
+
+		if( arg.substr(0,2) == "-j" )     // multithreading
+		{
+			nbFlags++;
+			g_data.nbThreads = 3;
+			if( arg.size() > 2 )
+			{
+				g_data.nbThreads = std::atoi( arg.c_str()+2 );
+				if( g_data.nbThreads < 1 || g_data.nbThreads > 9 )
+				{
+					std::cerr << "invalid switch !\n";
+					exit(RV_invalidSwitch);
+				}
+			}
+			cout << " -Option -j (" << g_data.nbThreads << " threads) activated\n";
+		}
+
+		if( arg == "-b" )
+		{
+			nbFlags++;
+			g_data.xcyclesBatch = true;
+			cout << " -Option -b (X-cycles batch mode) activated\n";
+		}
+
 		if( arg == "-s" )
 		{
 			nbFlags++;
@@ -157,6 +205,7 @@ int main( int argc, const char** argv )
 
 	if( !hasFileFlag && nbFlags+1 < argc )
 	{
+		ALLOC_PHASE( AP_PARSING );
 		if( !grid.buildFromString( argv[argc-1] ) )
 		{
 			cout << "Error: invalid grid string given\n";
@@ -164,7 +213,10 @@ int main( int argc, const char** argv )
 		}
 	}
 
-	grid.initCandidates();
+	{
+		ALLOC_PHASE( AP_PARSING );
+		grid.initCandidates();
+	}
 	if( saveGridToFile )
 	{
 		grid.saveToFile( "grid_start.sud" );
@@ -177,6 +229,20 @@ int main( int argc, const char** argv )
 		grid.saveToFile( oss.str() );
 	}
 
+	if( nextHint )
+	{
+		if( !grid.Check() )      // the algorithms assume a valid grid
+		{
+			std::cout << "Grid is invalid\n";
+			return RV_invalidGrid;
+		}
+		auto hint = grid.FindHint();
+		cout << "hint: " << hint << '\n';
+		if( hint._contradiction != CO_None )
+			return RV_contradiction;
+		return hint.Found() ? RV_success : RV_solvingFailure;
+	}
+
     cout << "Starting grid:\n" << grid << endl;
     if( g_data.Verbose )
 		grid.PrintCandidates( cout, "start" );
@@ -196,10 +262,35 @@ int main( int argc, const char** argv )
 	}
 	else
 	{
-		cout << "failure, used " << g_data.NbSteps << " steps\n";
+		const auto& status = grid.GetStatus();
+		bool wrongDeduction = ( status._contradiction == CO_WrongRemoval || status._contradiction == CO_WrongAssignment );
+		if( status._contradiction != CO_None )
+		{
+			if( wrongDeduction )           // the grid may well have a solution, the solver is wrong
+				cout << "wrong deduction, used " << g_data.NbSteps << " steps: " << GetString( status._contradiction );
+			else
+				cout << "contradiction, used " << g_data.NbSteps << " steps: " << GetString( status._contradiction );
+			if( status._contradiction == CO_EmptyCell || wrongDeduction || status._contradiction == CO_TwoValues )
+				cout << " at " << GetPosFromCellIndex( status._where ) << '\n';
+			else if( status._contradiction == CO_Propagation )    // no location
+				cout << '\n';
+			else
+			{
+				auto u = status._where;
+				cout << " in " << GetString( u<9 ? OR_ROW : ( u<18 ? OR_COL : OR_BLK ) ) << ' ' << u%9+1 << '\n';
+			}
+			ret = ( wrongDeduction ? RV_wrongDeduction : RV_contradiction );
+		}
+		else
+		{
+			cout << "failure, used " << g_data.NbSteps << " steps\n";
+			ret = RV_solvingFailure;
+		}
 		grid.PrintCandidates( cout, "final" );
-		ret = RV_solvingFailure;
 	}
 	cout << grid;
+#ifdef COUNT_ALLOCATIONS
+	PrintAllocCounts( cout );
+#endif
     return ret;
 }
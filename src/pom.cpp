@@ -0,0 +1,182 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file pom.cpp
+\brief Pattern Overlay Method implementation
+
+See http://www.sudokuwiki.org/Pattern_Overlay
+
+A template is one of the 46656 ways to place a value in the grid: one cell per row, per col and per block.
+For a given value, only the templates holding all the cells where the value is placed and no cell where it is
+not a candidate are kept, and the value can be removed from the cells that none of them cover.
+This covers all the single value techniques (fish, coloring, X-cycles).
+*/
+
+#include <algorithm>
+
+#include "grid.h"
+#include "header.h"
+#include "pom.h"
+#include "algorithms.h"
+
+//----------------------------------------------------------------------------
+/// Recursive helper function for GetTemplates(): adds to \c out all the templates completing \c current from row \c row
+void
+AddTemplates( index_t row, uint16_t usedCols, uint16_t usedBlocks, CellSet& current, Templates& out )
+{
+	if( row == 9 )
+	{
+		out.push_back( current );
+		return;
+	}
+	for( index_t col=0; col<9; col++ )
+	{
+		auto blk = GetBlockIndex( row, col );
+		if( ( usedCols & (1<<col) ) || ( usedBlocks & (1<<blk) ) )
+			continue;
+		current.set( row*9+col );
+		AddTemplates( row+1, usedCols | (1<<col), usedBlocks | (1<<blk), current, out );
+		current.reset( row*9+col );
+	}
+}
+//----------------------------------------------------------------------------
+/// Returns the templates, computed at first call
+const Templates&
+GetTemplates()
+{
+	static Templates templates = []()
+	{
+		Templates t;
+		t.reserve( NB_TEMPLATES );
+		CellSet current;
+		AddTemplates( 0, 0, 0, current, t );
+		assert( t.size() == NB_TEMPLATES );
+		return t;
+	}();
+	return templates;
+}
+//----------------------------------------------------------------------------
+/// Computes in \c removals the cells where a value can be removed, given the cells where it is placed (\c placed)
+/// and the cells where it is a candidate (\c board, see Grid::GetCandidateBoard())
+/**
+If no template fits, the grid is invalid: nothing is removed, and \c CO_MissingValue is returned,
+with in \c where a unit where the value has no place left.
+If all the units still have some place for it, that unit is the first row that no template can reach,
+once placed in the rows above.
+*/
+EN_CONTRADICTION
+PatternOverlayRemovals( const CellSet& placed, const CellSet& board, CellSet& removals, index_t& where )
+{
+	auto forbidden = ~( placed | board );
+	CellSet covered;
+	for( const auto& t: GetTemplates() )
+		if( ( t & forbidden ).none() && ( t & placed ) == placed )
+			covered |= t;
+
+	removals.reset();
+	if( covered.any() )
+	{
+		removals = board & ~covered;
+		return CO_None;
+	}
+
+	const auto& units = GetUnitsTable();
+	for( index_t u=0; u<27; u++ )
+		if( std::none_of( units[u].begin(), units[u].end(), [&]( index_t c ){ return !forbidden[c]; } ) )
+		{
+			where = u;
+			return CO_MissingValue;
+		}
+
+	index_t nbRows = 0;                               // nb of leading rows that some template fits
+	for( const auto& t: GetTemplates() )
+	{
+		index_t r = 0;
+		for( ; r<9; r++ )
+		{
+			bool fits = true;
+			for( index_t c=r*9; c<r*9+9; c++ )
+				if( ( t[c] && forbidden[c] ) || ( placed[c] && !t[c] ) )
+					fits = false;
+			if( !fits )
+				break;
+		}
+		nbRows = std::max( nbRows, r );
+	}
+	where = nbRows;                                   // less than 9, as no template fits all the rows
+	return CO_MissingValue;
+}
+//----------------------------------------------------------------------------
+/// Pattern Overlay Method, see PatternOverlayRemovals()
+/**
+All the removals found on the 9 values are applied in one call.
+
+If the grid shows up as invalid for some value, this is reported through the grid status (see Grid::SetContradiction()),
+and nothing is removed.
+*/
+bool
+Algo_PatternOverlay( Grid& g )
+{
+	PRINT_ALGO_START_2;
+
+	std::array<CellSet,9> placed;
+	std::array<CellSet,9> boards;
+	for( index_t c=0; c<81; c++ )
+	{
+		const auto& cell = g.getCell(c);
+		if( cell.GetValue() != 0 )
+			placed[ cell.GetValue()-1 ].set( c );
+		auto mask = cell.GetCandMask();
+		for( index_t d=0; d<9; d++ )
+			if( mask & (1<<d) )
+				boards[d].set( c );
+	}
+
+	std::array<CellSet,9> removals;
+	for( value_t val=1; val<10; val++ )
+	{
+		index_t where = 0;
+		auto co = PatternOverlayRemovals( placed[val-1], boards[val-1], removals[val-1], where );
+		if( co != CO_None )
+		{
+			COUT( "PatternOverlay: grid is invalid, no template fits value " << (int)val );
+			g.SetContradiction( co, where );
+			return false;
+		}
+	}
+
+	bool retval( false );
+	for( value_t val=1; val<10; val++ )
+	{
+		if( removals[val-1].any() )
+			COUT( "PatternOverlay: value " << (int)val << ", nb removals=" << removals[val-1].count() );
+		for( auto c: removals[val-1] )
+			if( g.getCell(c).RemoveCandidate( val ) )
+				retval = true;
+	}
+	return retval;
+}
+//----------------------------------------------------------------------------
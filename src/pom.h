@@ -0,0 +1,47 @@
+/**************************************************************************
+
+    This file is part of sudoku_cpp.
+    homepage: https://github.com/skramm/sudoku_cpp
+
+    Author & Copyright 2017-2023 Sebastien Kramm
+
+    Contact: firstname.lastname@univ-rouen.fr
+
+    Licence: LGPL v3
+
+    This library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+	See included lgpl.txt and gpl.txt files.
+
+**************************************************************************/
+
+/**
+\file
+\brief specific header file for Pattern Overlay Method
+*/
+
+#ifndef POM_H_
+#define POM_H_
+
+#include <vector>
+#include <bitset>
+
+/// Nb of ways to place a value in the grid: 9*6*3 for the first band, times 6*4*2 and 3*2*1 for the two others
+const size_t NB_TEMPLATES = 46656;
+
+/// The possible placements (templates) of a value, as 81-bit masks indexed by GetCellIndex(). See GetTemplates()
+using Templates = std::vector<CellSet>;
+
+const Templates& GetTemplates();
+EN_CONTRADICTION PatternOverlayRemovals( const CellSet& placed, const CellSet& board, CellSet& removals, index_t& where );
+bool Algo_PatternOverlay( Grid& g );
+
+#endif
@@ -26,6 +26,7 @@
 
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
 #include "catch.hpp"
+#include <sstream>
 
 
 #include "algorithms.h"
@@ -64,6 +65,29 @@ TEST_CASE( "test of position/index conversions", "tposi" )
 
 }
 
+TEST_CASE( "test of units and peers tables", "[tables]" )
+{
+	const auto& units = GetUnitsTable();
+	CHECK( units[0][8]  == GetCellIndex( pos_t(0,8) ) );   // row A
+	CHECK( units[9][8]  == GetCellIndex( pos_t(8,0) ) );   // col 1
+	CHECK( units[22][4] == GetCellIndex( pos_t(4,4) ) );   // center block
+	CHECK( units[26][0] == GetCellIndex( pos_t(6,6) ) );
+
+	const auto& peers = GetPeersTable();
+	auto it_b = std::begin( peers[0] );
+	auto it_e = std::end( peers[0] );
+	CHECK( std::find( it_b, it_e, GetCellIndex( pos_t(2,2) ) ) != it_e );
+	CHECK( std::find( it_b, it_e, GetCellIndex( pos_t(8,0) ) ) != it_e );
+	CHECK( std::find( it_b, it_e, GetCellIndex( pos_t(3,3) ) ) == it_e );
+	CHECK( std::find( it_b, it_e, 0 ) == it_e );
+
+	const auto& masks = GetPeerMasks();
+	CHECK( masks[0].count() == 20 );
+	CHECK( masks[0][ GetCellIndex( pos_t(2,2) ) ] );
+	CHECK( !masks[0][ GetCellIndex( pos_t(3,3) ) ] );
+	CHECK( !masks[0][0] );
+}
+
 TEST_CASE( "test of reading grid from string", "[readstring]" )
 {
 	Grid g;
@@ -75,128 +99,459 @@ TEST_CASE( "test of reading grid from string", "[readstring]" )
 	CHECK( !g.buildFromString( s3 ) );
 }
 
-TEST_CASE( "test of overlap", "[overlap1]" )
+/// used only for unit testing: returns the candidates mask of a cell, see Cell::GetCandMask()
+uint16_t
+CandMask( std::initializer_list<value_t> li )
 {
-	std::vector<int> v1{1,2,3};
-	{
-		std::vector<int> v2{1,2};
-
-		REQUIRE( VectorsOverlap(v1,v2,2) == true );
-		REQUIRE( VectorsOverlap(v2,v1,2) == true );
-		REQUIRE( VectorsOverlap(v1,v2,1) == true );
-		REQUIRE( VectorsOverlap(v2,v1,1) == true );
-		REQUIRE( VectorsOverlap(v1,v2,3) == false );
-		REQUIRE( VectorsOverlap(v2,v1,3) == false );
-	}
-	{
-		std::vector<int> v2{1,4};
-
-		REQUIRE( VectorsOverlap(v1,v2,2) == false );
-		REQUIRE( VectorsOverlap(v2,v1,2) == false );
-		REQUIRE( VectorsOverlap(v1,v2,1) == true );
-		REQUIRE( VectorsOverlap(v2,v1,1) == true );
-		REQUIRE( VectorsOverlap(v1,v2,3) == false );
-		REQUIRE( VectorsOverlap(v2,v1,3) == false );
-	}
+	uint16_t m = 0;
+	for( auto v: li )
+		m |= 1<<(v-1);
+	return m;
+}
+
+TEST_CASE( "test of candidate sets", "[candset]" )
+{
+	CandSet s1( CandMask( {1,3,9} ) );
+	CandSet s2( CandMask( {3,4} ) );
+
+	std::vector<value_t> v;
+	for( auto c: s1 )
+		v.push_back( c );
+	REQUIRE( v == std::vector<value_t>( {1,3,9} ) );
+	REQUIRE( s1.Size() == 3 );
+	REQUIRE( s1.Has( 9 ) );
+	REQUIRE( !s1.Has( 2 ) );
+
+	REQUIRE( ( s1 & s2 ) == CandSet( CandMask( {3} ) ) );
+	REQUIRE( ( s1 | s2 ) == CandSet( CandMask( {1,3,4,9} ) ) );
+	REQUIRE( ( s1 & CandSet() ).Empty() );
+	REQUIRE( CandSet::All().Size() == 9 );
+
+	Cell cell;
+	REQUIRE( cell.GetCandidates() == CandSet::All() );
+	cell.RemoveCellCandidates( s1 );
+	REQUIRE( cell.GetCandidates() == CandSet( CandMask( {2,4,5,6,7,8} ) ) );
+	REQUIRE( cell.NbCandidates() == 6 );
 }
 
-TEST_CASE( "test of naked triple search", "[triple]" )
+TEST_CASE( "test of cell sets", "[cellset]" )
 {
-	std::array<value_t,3> trip_val{1,2,3} ;
-	std::array<index_t,3> trip_pos{4,5,6} ;
+	CellSet s1;
+	s1.set( 0 ).set( 63 ).set( 64 ).set( 80 );
+	CHECK( s1.count() == 4 );
+	CHECK( s1.test( 63 ) );
+	CHECK( s1[64] );
+	CHECK( !s1.test( 62 ) );
+
+	std::vector<index_t> v;
+	for( auto c: s1 )
+		v.push_back( c );
+	CHECK( v == std::vector<index_t>( {0,63,64,80} ) );
+
+	CellSet s2;
+	s2.set( 63 ).set( 79 );
+	CHECK( ( s1 & s2 ).count() == 1 );
+	CHECK( ( s1 | s2 ).count() == 5 );
+	CHECK( ( s1 & ~s1 ).none() );
+	CHECK( (~CellSet()).count() == 81 );
+	CHECK( CellSet().set().count() == 81 );
+	CHECK( s1.reset( 63 ).count() == 3 );
+
+	for( index_t c=0; c<81; c++ )        // each cell has 20 peers
+		CHECK( GetPeerMasks()[c].count() == 20 );
+}
+
+TEST_CASE( "test of naked subsets search", "[triple]" )
+{
+	const uint16_t trip_cand = CandMask( {1,2,3} );
+	const uint16_t trip_pos  = (1<<4) | (1<<5) | (1<<6);
+	UnitSubsets found;
 	{
 		INFO( "test case A" )
-		std::vector<Pos_vcand> v;
-		v.emplace_back( 3, std::vector<value_t>{4,5} );
-		v.emplace_back( 4, std::vector<value_t>{1,2,3} );
-		v.emplace_back( 5, std::vector<value_t>{1,2,3} );
-		v.emplace_back( 6, std::vector<value_t>{1,2,3} );
-
-		auto res = SearchTriplesPattern( v );
-		CHECK( res.found_NT == true );
-		CHECK( res.cand_values == trip_val );
-		CHECK( res.cand_pos == trip_pos );
+		std::array<uint16_t,9> v{};
+		v[3] = CandMask( {4,5} );
+		v[4] = CandMask( {1,2,3} );
+		v[5] = CandMask( {1,2,3} );
+		v[6] = CandMask( {1,2,3} );
+
+		CHECK( FindNakedSubsets( v, 3, found ) == 1 );
+		CHECK( found[0]._cands == trip_cand );
+		CHECK( found[0]._cells == trip_pos );
+		CHECK( FindNakedSubsets( v, 2, found ) == 0 );
 	}
 	{
 		INFO( "test case B" )
-		std::vector<Pos_vcand> v;
-		v.emplace_back( 3, std::vector<value_t>{4,5} );
-		v.emplace_back( 4, std::vector<value_t>{1,2} );
-		v.emplace_back( 5, std::vector<value_t>{1,2,3} );
-		v.emplace_back( 6, std::vector<value_t>{1,2,3} );
-
-		auto res = SearchTriplesPattern( v );
-		CHECK( res.found_NT == true );
-		CHECK( res.cand_values == trip_val );
-		CHECK( res.cand_pos == trip_pos );
+		std::array<uint16_t,9> v{};
+		v[3] = CandMask( {4,5} );
+		v[4] = CandMask( {1,2} );
+		v[5] = CandMask( {1,2,3} );
+		v[6] = CandMask( {1,2,3} );
+
+		CHECK( FindNakedSubsets( v, 3, found ) == 1 );
+		CHECK( found[0]._cands == trip_cand );
+		CHECK( found[0]._cells == trip_pos );
 	}
 	{
-		INFO( "test case C - no good" )
-		std::vector<Pos_vcand> v;
-		v.emplace_back( 3, std::vector<value_t>{4,5} );
-		v.emplace_back( 4, std::vector<value_t>{1,2} );
-		v.emplace_back( 5, std::vector<value_t>{1,2} );
-		v.emplace_back( 6, std::vector<value_t>{1,2,3} );
-
-		auto res = SearchTriplesPattern( v );
-		CHECK( res.found_NT == false );
+		INFO( "test case C - pair included in a triple" )
+		std::array<uint16_t,9> v{};
+		v[3] = CandMask( {4,5} );
+		v[4] = CandMask( {1,2} );
+		v[5] = CandMask( {1,2} );
+		v[6] = CandMask( {1,2,3} );
+
+		CHECK( FindNakedSubsets( v, 3, found ) == 1 );
+		CHECK( found[0]._cands == trip_cand );
+		CHECK( found[0]._cells == trip_pos );
+		CHECK( FindNakedSubsets( v, 2, found ) == 1 );
+		CHECK( found[0]._cands == CandMask( {1,2} ) );
+		CHECK( found[0]._cells == ( (1<<4) | (1<<5) ) );
 	}
 	{
 		INFO( "test case C - good" )
-		std::vector<value_t> vC{2,3};
-
-		std::vector<Pos_vcand> v;
-		v.emplace_back( 3, std::vector<value_t>{4,5} );
-		v.emplace_back( 4, std::vector<value_t>{1,2} );
-		v.emplace_back( 5, std::vector<value_t>{2,3} );
-		v.emplace_back( 6, std::vector<value_t>{1,2,3} );
-
-		auto res = SearchTriplesPattern( v );
-		CHECK( res.found_NT == true );
-		CHECK( res.cand_values == trip_val );
-		CHECK( res.cand_pos == trip_pos );
+		std::array<uint16_t,9> v{};
+		v[3] = CandMask( {4,5} );
+		v[4] = CandMask( {1,2} );
+		v[5] = CandMask( {2,3} );
+		v[6] = CandMask( {1,2,3} );
+
+		CHECK( FindNakedSubsets( v, 3, found ) == 1 );
+		CHECK( found[0]._cands == trip_cand );
+		CHECK( found[0]._cells == trip_pos );
 	}
 	{
 		INFO( "test case D1 - no good" )
-		std::cout << "case D1 - no good\n";
-		std::vector<Pos_vcand> v;
-		v.emplace_back( 3, std::vector<value_t>{4,5} );
-		v.emplace_back( 4, std::vector<value_t>{1,6} );
-		v.emplace_back( 5, std::vector<value_t>{1,2} );
-		v.emplace_back( 6, std::vector<value_t>{7,8} );
-
-		auto res = SearchTriplesPattern( v );
-		CHECK( res.found_NT == false );
+		std::array<uint16_t,9> v{};
+		v[3] = CandMask( {4,5} );
+		v[4] = CandMask( {1,6} );
+		v[5] = CandMask( {1,2} );
+		v[6] = CandMask( {7,8} );
+
+		CHECK( FindNakedSubsets( v, 3, found ) == 0 );
 	}
 	{
 		INFO( "test case D2 - good" )
-		std::cout << "case D2 - good\n";
-		std::vector<Pos_vcand> v;
-		v.emplace_back( 2, std::vector<value_t>{1,4} );
-		v.emplace_back( 3, std::vector<value_t>{4,5} );
-		v.emplace_back( 4, std::vector<value_t>{1,3} );
-		v.emplace_back( 5, std::vector<value_t>{1,2} );
-		v.emplace_back( 6, std::vector<value_t>{2,3} );
-
-		auto res = SearchTriplesPattern( v );
-		CHECK( res.found_NT == true );
-		CHECK( res.cand_values == trip_val );
-		CHECK( res.cand_pos == trip_pos );
-	}
+		std::array<uint16_t,9> v{};
+		v[2] = CandMask( {1,4} );
+		v[3] = CandMask( {4,5} );
+		v[4] = CandMask( {1,3} );
+		v[5] = CandMask( {1,2} );
+		v[6] = CandMask( {2,3} );
 
+		CHECK( FindNakedSubsets( v, 3, found ) == 1 );
+		CHECK( found[0]._cands == trip_cand );
+		CHECK( found[0]._cells == trip_pos );
+	}
 	{
 		INFO( "test case D3 - no good" )
-		std::cout << "case D3 - no good\n";
-		std::vector<Pos_vcand> v;
-		v.emplace_back( 3, std::vector<value_t>{3,9} );
-		v.emplace_back( 4, std::vector<value_t>{6,9} );
-		v.emplace_back( 5, std::vector<value_t>{3,6,8} );
-		v.emplace_back( 6, std::vector<value_t>{3,5} );
-
-		auto res = SearchTriplesPattern( v );
-		CHECK( res.found_NT == false );
+		std::array<uint16_t,9> v{};
+		v[3] = CandMask( {3,9} );
+		v[4] = CandMask( {6,9} );
+		v[5] = CandMask( {3,6,8} );
+		v[6] = CandMask( {3,5} );
+
+		CHECK( FindNakedSubsets( v, 3, found ) == 0 );
+	}
+	{
+		INFO( "naked quad, and the two pairs of a full row" )
+		std::array<uint16_t,9> v{};
+		v[0] = CandMask( {1,5} );
+		v[2] = CandMask( {1,2,5} );
+		v[4] = CandMask( {2,6} );
+		v[7] = CandMask( {5,6} );
+		v[8] = CandMask( {1,3,7} );
+
+		CHECK( FindNakedSubsets( v, 4, found ) == 1 );
+		CHECK( found[0]._cands == CandMask( {1,2,5,6} ) );
+		CHECK( found[0]._cells == ( (1<<0) | (1<<2) | (1<<4) | (1<<7) ) );
+
+		std::array<uint16_t,9> v2{};
+		v2[1] = CandMask( {1,2} );
+		v2[3] = CandMask( {3,4} );
+		v2[5] = CandMask( {1,2} );
+		v2[6] = CandMask( {3,4} );
+		CHECK( FindNakedSubsets( v2, 2, found ) == 2 );
+	}
+}
+
+TEST_CASE( "test of hidden subsets search", "[hidden]" )
+{
+	UnitSubsets found;
+	{
+		INFO( "hidden pair" )
+		std::array<uint16_t,9> v{};
+		v[0] = CandMask( {1,2,4,7} );
+		v[1] = CandMask( {4,5} );
+		v[2] = CandMask( {1,2,5,8} );
+		v[3] = CandMask( {3,4,5,8} );
+		v[4] = CandMask( {3,7,8} );
+		v[5] = CandMask( {4,6,7} );
+		v[6] = CandMask( {6,8} );
+
+		CHECK( FindHiddenSubsets( v, 2, found ) == 1 );
+		CHECK( found[0]._cands == CandMask( {1,2} ) );
+		CHECK( found[0]._cells == ( (1<<0) | (1<<2) ) );
 	}
+	{
+		INFO( "hidden triple, with no cell holding the three digits" )
+		std::array<uint16_t,9> v{};
+		v[0] = CandMask( {1,2,4,5} );
+		v[1] = CandMask( {4,5,6} );
+		v[3] = CandMask( {2,6,9} );
+		v[4] = CandMask( {4,5,6,8} );
+		v[6] = CandMask( {5,6,8} );
+		v[8] = CandMask( {1,4,9} );
 
+		CHECK( FindHiddenSubsets( v, 2, found ) == 0 );
+		CHECK( FindHiddenSubsets( v, 3, found ) == 1 );
+		CHECK( found[0]._cands == CandMask( {1,2,9} ) );
+		CHECK( found[0]._cells == ( (1<<0) | (1<<3) | (1<<8) ) );
+	}
+}
+
+TEST_CASE( "test of hidden singles search", "[hsingle]" )
+{
+	std::array<uint16_t,81> v;
+	std::array<uint16_t,81> singles;
+	v.fill( 0x1FF );
+	CHECK( FindHiddenSingles( v, singles ) == 0 );
+
+	for( index_t c=0; c<9; c++ )      // value 5 only in cell A4 on the first row
+		if( c != 3 )
+			v[c] &= ~CandMask( {5} );
+	CHECK( FindHiddenSingles( v, singles ) == 1 );
+	CHECK( singles[3] == CandMask( {5} ) );
+
+	for( index_t c=8; c<81; c+=9 )    // value 7 only in cell J9, both in last col and in last block
+		if( c != 80 )
+			v[c] &= ~CandMask( {7} );
+	for( index_t c: { 60, 61, 69, 70, 78, 79 } )
+		v[c] &= ~CandMask( {7} );
+	CHECK( FindHiddenSingles( v, singles ) == 2 );
+	CHECK( singles[3]  == CandMask( {5} ) );
+	CHECK( singles[80] == CandMask( {7} ) );
+
+	Grid g;
+	g.buildFromString( std::string( 81, '.' ) );
+	g.InitStatus();
+	for( index_t c=1; c<9; c++ )      // A1 is the only place for 1 in row A, and for 2 in col 1
+	{
+		g.getCell( c ).RemoveCandidate( 1 );
+		g.getCell( c*9 ).RemoveCandidate( 2 );
+	}
+	CHECK( g.GetStatus()._contradiction == CO_None );
+	CHECK( Algo_SearchSingleCand( g ) == false );
+	CHECK( g.GetStatus()._contradiction == CO_TwoValues );
+	CHECK( g.GetStatus()._where == 0 );
+	CHECK( g.getCell( 0 ).GetValue() == 0 );
+}
+
+TEST_CASE( "test of intersection removal", "[intersect]" )
+{
+	const auto& table = GetIntersectionsTable();
+	const auto& inter = table[0];          // first row, first block
+	CHECK( inter._orient == OR_ROW );
+	CHECK( inter._inter.count() == 3 );
+	CHECK( table[53]._orient == OR_COL );
+	CHECK( table[53]._inter[80] );
+
+	CellSet board;
+	for( index_t c: { 1, 2, 5, 7, 27, 30 } )     // A2 A3 A6 A8 D1 D4
+		board.set( c );
+	{
+		INFO( "pointing pair" )
+		auto rem = IntersectionRemovals( board, inter, B_PointingPairsTriples );
+		CHECK( rem.count() == 2 );
+		CHECK( rem[5] );
+		CHECK( rem[7] );
+		CHECK( IntersectionRemovals( board, inter, B_BoxReduction ).none() );
+	}
+	board.reset( 5 );
+	board.reset( 7 );
+	board.set( 19 );                             // B2
+	{
+		INFO( "box reduction" )
+		auto rem = IntersectionRemovals( board, inter, B_BoxReduction );
+		CHECK( rem.count() == 1 );
+		CHECK( rem[19] );
+		CHECK( IntersectionRemovals( board, inter, B_PointingPairsTriples ).none() );
+	}
+}
+
+TEST_CASE( "test of wings", "[wings]" )
+{
+	{
+		INFO( "XYZ-Wing" )
+		Grid g;
+		g.buildFromString( std::string( 81, '.' ) );
+		g.getCell(0).RemoveCandidates( 0x1FF & ~CandMask( {1,2,3} ) );  // pivot A1
+		g.getCell(1).RemoveCandidates( 0x1FF & ~CandMask( {1,3} ) );    // pincer A2
+		g.getCell(9).RemoveCandidates( 0x1FF & ~CandMask( {2,3} ) );    // pincer B1
+		CHECK( Algo_XY_Wing( g ) == false );
+		CHECK( Algo_XYZ_Wing( g ) == true );
+		for( index_t c: { 2, 10, 11, 18, 19, 20 } )                     // rest of the block
+			CHECK( !g.getCell(c).HasCandidate( 3 ) );
+		CHECK( g.getCell(3).HasCandidate( 3 ) );
+		CHECK( g.getCell(0).HasCandidate( 3 ) );
+	}
+	{
+		INFO( "W-Wing" )
+		Grid g;
+		g.buildFromString( std::string( 81, '.' ) );
+		g.getCell(0).RemoveCandidates(  0x1FF & ~CandMask( {1,2} ) );   // A1
+		g.getCell(44).RemoveCandidates( 0x1FF & ~CandMask( {1,2} ) );   // E9
+		for( index_t c=28; c<35; c++ )                                 // strong link on 1 in row D: D1-D9
+			g.getCell(c).RemoveCandidate( 1 );
+		CHECK( Algo_W_Wing( g ) == true );
+		CHECK( !g.getCell(8).HasCandidate( 2 ) );                        // A9
+		CHECK( !g.getCell(36).HasCandidate( 2 ) );                       // E1
+		CHECK( g.getCell(7).HasCandidate( 2 ) );
+	}
+}
+
+TEST_CASE( "test of fish", "[fish]" )
+{
+	Grid g;
+	g.buildFromString( std::string( 81, '.' ) );
+	for( index_t r: { 0, 3 } )             // value 5 only in cols 2 and 5 on rows A and D
+		for( index_t c=0; c<9; c++ )
+			if( c != 1 && c != 4 )
+				g.GetCellByPos( pos_t(r,c) ).RemoveCandidate( 5 );
+
+	CHECK( Algo_X_Wing( g ) == true );
+	for( index_t r=0; r<9; r++ )
+	{
+		bool base = ( r == 0 || r == 3 );
+		CHECK( g.GetCellByPos( pos_t(r,1) ).HasCandidate( 5 ) == base );
+		CHECK( g.GetCellByPos( pos_t(r,4) ).HasCandidate( 5 ) == base );
+		CHECK( g.GetCellByPos( pos_t(r,2) ).HasCandidate( 5 ) == !base );
+	}
+	CHECK( Algo_X_Wing( g ) == false );
+}
+
+/// used only for unit testing: candidate board of a value, all cells but the ones in \c v_clear
+CellSet
+BuildBoard( const std::vector<std::pair<std::vector<index_t>,std::vector<index_t>>>& v_clear )
+{
+	CellSet board;
+	board.set();
+	for( const auto& p: v_clear )           // clear the unit p.first, except the cells in p.second
+		for( auto c: GetUnitsTable()[p.first[0]] )
+			if( std::find( p.second.begin(), p.second.end(), c ) == p.second.end() )
+				board.reset( c );
+	return board;
+}
+
+TEST_CASE( "test of coloring", "[coloring]" )
+{
+	{
+		ParityUnionFind<10> uf;
+		CHECK( uf.Union( 1, 2 ) );
+		CHECK( uf.Union( 2, 3 ) );
+		CHECK( uf.Union( 5, 3 ) );
+		uint8_t p1, p3, p5;
+		auto r1 = uf.Find( 1, p1 );
+		CHECK( uf.Find( 3, p3 ) == r1 );
+		CHECK( uf.Find( 5, p5 ) == r1 );
+		CHECK( p1 == p3 );
+		CHECK( p1 != p5 );
+		CHECK( uf.Union( 1, 3 ) == false );
+	}
+	{
+		INFO( "color trap: chain A1-A5-B6-F6, F1 sees A1 and F6" )
+		auto board = BuildBoard( { {{0},{0,4}}, {{19},{4,14}}, {{14},{14,50}} } );  // row A, block 2, col 6
+		auto rem = ColorValue( board, 1 );
+		CHECK( rem.count() == 1 );
+		CHECK( rem[45] );
+	}
+	{
+		INFO( "color wrap: chain A1-A5-B6-F6-F1, A1 and F1 are of same color" )
+		auto board = BuildBoard( { {{0},{0,4}}, {{19},{4,14}}, {{14},{14,50}}, {{5},{50,45}} } );  // row A, block 2, col 6, row F
+		auto rem = ColorValue( board, 1 );
+		CHECK( rem.count() == 3 );
+		CHECK( rem[0] );
+		CHECK( rem[14] );
+		CHECK( rem[45] );
+	}
+	{
+		INFO( "3D Medusa, two colors in cell A5" )
+		std::array<CellSet,9> boards;
+		for( auto& b: boards )
+			b.set();
+		for( value_t v=3; v<10; v++ )             // A1 holds only 1 and 2
+			boards[v-1].reset( 0 );
+		for( index_t c=1; c<9; c++ )              // in row A, 1 and 2 are only in A1 and A5
+			if( c != 4 )
+			{
+				boards[0].reset( c );
+				boards[1].reset( c );
+			}
+		auto rem = MedusaRemovals( boards );
+		CHECK( rem[0].none() );
+		CHECK( rem[1].none() );
+		for( value_t v=3; v<10; v++ )
+		{
+			CHECK( rem[v-1].count() == 1 );
+			CHECK( rem[v-1][4] );
+		}
+	}
+}
+
+TEST_CASE( "test of ALS index", "[als]" )
+{
+	AlsIndex index;
+	std::array<uint16_t,81> v{};
+	v[0] = CandMask( {1,2} );
+	v[1] = CandMask( {1,2,3} );
+	BuildAlsIndex( v, ALS_MAX_CELLS, index );
+	CHECK( index._nb == 2 );                   // A1, and A1+A2, each found only once
+
+	v[10] = CandMask( {3,4} );                 // B2
+	BuildAlsIndex( v, ALS_MAX_CELLS, index );
+	CHECK( index._nb == 4 );                   // + B2, and A1+A2+B2 (block)
+	BuildAlsIndex( v, 2, index );
+	CHECK( index._nb == 3 );
+}
+
+/// used only for unit testing: the candidates removed from \c g since \c before was taken, as (cell index,value) pairs
+std::vector<std::pair<index_t,value_t>>
+GetRemovals( const std::array<uint16_t,81>& before, const Grid& g )
+{
+	std::vector<std::pair<index_t,value_t>> out;
+	for( index_t c=0; c<81; c++ )
+		for( value_t v=1; v<10; v++ )
+			if( ( before[c] & (1<<(v-1)) ) && !g.getCell(c).HasCandidate( v ) )
+				out.push_back( std::make_pair( c, v ) );
+	return out;
+}
+
+/// used only for unit testing
+std::array<uint16_t,81>
+GetCandMasks( const Grid& g )
+{
+	std::array<uint16_t,81> out;
+	for( index_t c=0; c<81; c++ )
+		out[c] = g.getCell(c).GetCandMask();
+	return out;
+}
+
+TEST_CASE( "test of ALS-XZ", "[alsxz]" )
+{
+	Grid g;
+	g.buildFromString( std::string( 81, '.' ) );
+	auto before = GetCandMasks( g );
+	CHECK( Algo_ALS_XZ( g ) == false );                              // no ALS: nothing to do
+	CHECK( GetRemovals( before, g ).empty() );
+
+	g.getCell(0).RemoveCandidates(  0x1FF & ~CandMask( {1,2} ) );    // ALS A: A1
+	g.getCell(36).RemoveCandidates( 0x1FF & ~CandMask( {1,3} ) );    // ALS B: E1-E5
+	g.getCell(40).RemoveCandidates( 0x1FF & ~CandMask( {2,3} ) );
+	before = GetCandMasks( g );
+	CHECK( Algo_ALS_XZ( g ) == true );                               // X=1 (A1-E1), Z=2: A5 sees A1 and E5
+	auto removed = GetRemovals( before, g );
+	CHECK( removed == std::vector<std::pair<index_t,value_t>>( { {4,2} } ) );
+	CHECK( Algo_ALS_XZ( g ) == false );
+	Grid g2( g );
+	CHECK( &g2.GetAlsIndex() != &g.GetAlsIndex() );                  // each grid has its own index, not shared by copies
 }
 
 /// used only for unit testing
@@ -223,9 +578,9 @@ CheckCycle( int n, const Cycle& c, En_CycleType ct, int pos=0 )
 	for( decltype(c.size()) i=0; i<c.size(); i++ )
 	{
 		std::rotate( std::begin( c2.data() ), std::begin( c2.data() )+1, std::end( c2.data() ) );
-		if( GetCycleType( c )._ctype != ct )
+		if( GetCycleType( c2 )._ctype != ct )        // the type does not depend on the first link
 		{
-			std::cout << "- Failure for cycle: " << c << ": Is not of required type\n";
+			std::cout << "- Failure for cycle: " << c2 << ": Is not of required type\n";
 			fail = true;
 		}
 	}
@@ -253,8 +608,504 @@ TEST_CASE( "test of cycle detection", "[cycles]" )
 	CheckCycle( n++, BuildCycle( "W-S-W-S-W-S" ), CT_Continuous );
 	CheckCycle( n++, BuildCycle( "W-S-W-W-S-W-S" ), CT_Discont_2WL, 2 );
 	CheckCycle( n++, BuildCycle( "W-S-W-S-S-W-S" ), CT_Discont_2SL, 3 );
+	CheckCycle( n++, BuildCycle( "S-W-S-W-S" ), CT_Discont_2SL, 4 );     // discontinuity between last and first link
+	CheckCycle( n++, BuildCycle( "S-S-S-W-S" ), CT_Discont_2SL, 1 );     // a strong link used as a weak one
+	CheckCycle( n++, BuildCycle( "S-W-S-S-S" ), CT_Discont_2SL, 2 );
+	CheckCycle( n++, BuildCycle( "W-S-S-W-S" ), CT_Discont_2SL, 1 );
+	CheckCycle( n++, BuildCycle( "W-S-W-W-S" ), CT_Discont_2WL, 2 );     // can not be 2SL: a weak link would be used as strong
+	CheckCycle( n++, BuildCycle( "S-W-S-W-S-W-S-W" ), CT_Continuous );
+	CheckCycle( n++, BuildCycle( "S-S-S-S" ), CT_Continuous );           // strong links used as weak ones
+
+// cases of the table in GetCycleType() documentation
+	CheckCycle( n++, BuildCycle( "S-W-S-W-S-W" ), CT_Continuous );
+	CheckCycle( n++, BuildCycle( "W-S-W-S-W-S-S" ), CT_Discont_2SL, 5 );
+	CheckCycle( n++, BuildCycle( "S-W-S-W-S-W-S" ), CT_Discont_2SL, 6 );
+	CheckCycle( n++, BuildCycle( "S-S-W-S-W-S-W" ), CT_Discont_2SL, 0 );
+	CheckCycle( n++, BuildCycle( "W-W-W-S-W-S" ), CT_Invalid );
+	CheckCycle( n++, BuildCycle( "W-W-S-W-S-W" ), CT_Invalid );
+	CheckCycle( n++, BuildCycle( "W-S-W-S-W-W" ), CT_Invalid );
+	CheckCycle( n++, BuildCycle( "S-W-S-W-W-W" ), CT_Invalid );
 
 	CheckCycle( n++, BuildCycle( "W-S-W-S-S-W-S-S" ), CT_Invalid ); // twice 2 strong links
 	CheckCycle( n++, BuildCycle( "W-W-S-W-S-W-W-S" ), CT_Invalid ); // twice 2 weak links
 }
 
+TEST_CASE( "test of cycle generator", "[cyclegen]" )
+{
+	std::vector<std::vector<size_t>> adj{ {1,2,3}, {0,2}, {0,1,3}, {0,2} };   // square 0-1-2-3, with diagonal 0-2
+	using Path = CycleGenerator::Path;
+	auto getAll = []( CycleGenerator& gen )
+	{
+		std::vector<Path> out;
+		Path cycle;
+		while( gen.Next( cycle ) )
+			out.push_back( cycle );
+		return out;
+	};
+
+	CycleGenerator gen1( adj, 12, 100, 1000 );              // shortest first, each cycle in one orientation only
+	CHECK( getAll( gen1 ) == std::vector<Path>( { {0,1,2}, {0,2,3}, {0,1,2,3} } ) );
+	CHECK( gen1.Count() == 3 );
+
+	CycleGenerator gen2( adj, 3, 100, 1000 );               // length budget
+	CHECK( getAll( gen2 ) == std::vector<Path>( { {0,1,2}, {0,2,3} } ) );
+
+	CycleGenerator gen3( adj, 12, 1, 1000 );                // count budget: early stop
+	CHECK( getAll( gen3 ) == std::vector<Path>( { {0,1,2} } ) );
+
+	auto noVertex1 = []( const Path& p ){ return std::find( p.begin(), p.end(), 1 ) == p.end(); };
+	CycleGenerator gen4( adj, 12, 1, 1000, noVertex1 );     // rejected cycles do not count
+	CHECK( getAll( gen4 ) == std::vector<Path>( { {0,2,3} } ) );
+
+	CycleGenerator gen5( adj, 12, 100, 3 );                 // work budget: stops even if no cycle closes
+	CHECK( getAll( gen5 ).empty() );
+	CHECK( gen5.Visits() == 3 );
+}
+
+TEST_CASE( "test of grouped x-cycles nodes", "[cycles2]" )
+{
+	XcNode n1( pos_t(0,0) );
+	CHECK( !n1.IsGroup() );
+	CHECK( n1.GetIndex() == 0 );
+	CHECK( XcNode( pos_t(8,8) ).GetIndex() == 80 );
+
+	CellSet board;
+	board.set( 0 ).set( 1 ).set( 6 ).set( 11 );     // A1, A2, A7, B3
+	XcNode g1( board & CellSet( 3 ) );         // group A1-A2
+	CHECK( g1.IsGroup() );
+	CHECK( g1.GetPos() == pos_t(0,0) );
+	CHECK( g1.GetIndex() == 81 );
+	CHECK( g1.GetBoard() == CellSet( 3 ) );
+
+	std::vector<Link> v_sl, v_wl;
+	FindGroupLinks( board, v_sl, v_wl );
+	CHECK( v_sl.size() == 2 );                          // A1A2-A7 (row), A1A2-B3 (block)
+	CHECK( v_wl.size() == 0 );
+	CHECK( v_sl[0] == Link( g1, XcNode( pos_t(0,6) ), LT_Strong, OR_ROW ) );
+
+	board.set( 19 );                                  // C2: block now has two overlapping groups, A1-A2 and A2-C2
+	v_sl.clear();
+	FindGroupLinks( board, v_sl, v_wl );
+	CHECK( v_sl.size() == 1 );
+	CHECK( v_wl.size() == 4 );                          // A1A2-B3, A1A2-C2, A2C2-A1, A2C2-B3
+	CellSet g2;
+	g2.set( 1 ).set( 19 );
+	CHECK( XcNode( g2 ).GetIndex() == 81 + 27 + 3 );
+}
+
+TEST_CASE( "test of AIC", "[aic]" )
+{
+	Grid g;
+	g.buildFromString( std::string( 81, '.' ) );
+	auto before = GetCandMasks( g );
+	CHECK( Algo_AIC( g ) == false );                                 // no strong link: nothing to do
+	CHECK( GetRemovals( before, g ).empty() );
+
+// chain: A1(1)=A1(2)-A6(2)=A6(7)-E6(7)=E9(7)-E9(1)=J9(1), so A1 or J9 holds 1
+	g.getCell(0).RemoveCandidates( 0x1FF & ~CandMask( {1,2} ) );     // A1
+	g.getCell(5).RemoveCandidates( 0x1FF & ~CandMask( {2,7} ) );     // A6
+	for( index_t c=36; c<45; c++ )                                 // strong link on 7 in row E: E6-E9
+		if( c != 41 && c != 44 )
+			g.getCell(c).RemoveCandidate( 7 );
+	Grid g2( g );
+	for( index_t r=0; r<9; r++ )                                   // strong link on 1 in col 9: E9-J9
+		if( r != 4 && r != 8 )
+			g.getCell(r*9+8).RemoveCandidate( 1 );
+	before = GetCandMasks( g );
+	CHECK( Algo_AIC( g ) == true );
+	auto removed = GetRemovals( before, g );
+	CHECK( removed == std::vector<std::pair<index_t,value_t>>( { {72,1} } ) );   // J1 sees A1 and J9
+
+	for( index_t r=0; r<9; r++ )                                   // 1 in col 9 also in D9: chain is broken
+		if( r != 3 && r != 4 && r != 8 )
+			g2.getCell(r*9+8).RemoveCandidate( 1 );
+	before = GetCandMasks( g2 );
+	CHECK( Algo_AIC( g2 ) == false );
+	CHECK( GetRemovals( before, g2 ).empty() );
+	CHECK( &g2.GetAicGraph() != &g.GetAicGraph() );                 // each grid has its own storage, not shared by copies
+}
+
+TEST_CASE( "test of x-cycles batch mode", "[xcbatch]" )
+{
+	Grid g;
+	g.buildFromString( std::string( 81, '.' ) );
+	g.initCandidates();
+	g.InitStatus();
+	CHECK( EliminationsAreConsistent( { Elimination( pos_t(0,0), 1 ), Elimination( pos_t(0,1), 2, true ) }, g ) );
+	CHECK( !EliminationsAreConsistent( { Elimination( pos_t(0,0), 1, true ), Elimination( pos_t(0,0), 2, true ) }, g ) );
+	CHECK( !EliminationsAreConsistent( { Elimination( pos_t(0,0), 1, true ), Elimination( pos_t(0,0), 1 ) }, g ) );
+	CHECK( !EliminationsAreConsistent( { Elimination( pos_t(0,0), 1, true ), Elimination( pos_t(4,0), 1, true ) }, g ) );
+
+	Grid g2( g );
+	g2.getCell( 9 ).RemoveCandidates( 0x1F3 );                // B1: 3,4 left
+	CHECK( EliminationsAreConsistent( { Elimination( pos_t(1,0), 4 ) }, g2 ) );
+	CHECK( !EliminationsAreConsistent( { Elimination( pos_t(1,0), 4 ), Elimination( pos_t(0,0), 3, true ) }, g2 ) );   // no candidate left in B1
+
+	XCyclesResults v_res;
+	for( index_t c=0; c<8; c++ )                               // one cycle per cell, removing 5 from A1 to A8
+		v_res[4].push_back( { Elimination( pos_t(0,c), 5 ) } );
+	v_res[4].push_back( { Elimination( pos_t(0,8), 5 ) } );    // and A9: no place left for 5 in row A
+	v_res[5].push_back( { Elimination( pos_t(8,8), 6 ) } );
+	CHECK( !EliminationsAreConsistent( { Elimination( pos_t(0,8), 5 ), Elimination( pos_t(1,8), 5 ), Elimination( pos_t(2,8), 5 ),
+		Elimination( pos_t(3,8), 5 ), Elimination( pos_t(4,8), 5 ), Elimination( pos_t(5,8), 5 ),
+		Elimination( pos_t(6,8), 5 ), Elimination( pos_t(7,8), 5 ), Elimination( pos_t(8,8), 5 ) }, g ) );
+
+	CHECK( ApplyBatchEliminations( v_res, g ) );                // not consistent: falls back to the first cycle only
+	CHECK( !g.getCell( 0 ).HasCandidate( 5 ) );
+	CHECK( g.getCell( 1 ).HasCandidate( 5 ) );
+	CHECK( g.getCell( 8 ).HasCandidate( 5 ) );
+	CHECK( g.getCell( 80 ).HasCandidate( 6 ) );
+
+	v_res[4].pop_back();
+	CHECK( ApplyBatchEliminations( v_res, g ) );                // consistent: all applied
+	for( index_t c=0; c<8; c++ )
+		CHECK( !g.getCell( c ).HasCandidate( 5 ) );
+	CHECK( g.getCell( 8 ).HasCandidate( 5 ) );
+	CHECK( !g.getCell( 80 ).HasCandidate( 6 ) );
+	CHECK( g.GetStatus()._contradiction == CO_None );
+}
+
+TEST_CASE( "test of parallel x-cycles search", "[xcparallel]" )
+{
+	Grid g;
+	g.buildFromString( "1....7.9..3..2...8..96..5....53..9...1..8...26....4...3......1..4......7..7...3.." );    // samples/sage_1.sud
+	g.initCandidates();
+	Algo_RemoveCandidates( g );
+
+	auto countCycles = []( const XCyclesResults& v_res )
+	{
+		size_t nb = 0;
+		for( const auto& v_elimByCycle: v_res )
+			nb += v_elimByCycle.size();
+		return nb;
+	};
+	Grid g1( g ), g4( g );
+	auto v_res1 = SearchAllCycles( g1, g1.GetXCyclesCache(), 1, false );
+	auto v_res4 = SearchAllCycles( g4, g4.GetXCyclesCache(), 4, false );
+	CHECK( countCycles( v_res1 ) == 1 );                 // stops at the first cycle enabling some removal
+	CHECK( ApplyFirstEliminations( v_res1, g1 ) );
+	CHECK( ApplyFirstEliminations( v_res4, g4 ) );       // same as the sequential search
+	CHECK( GetCandMasks( g1 ) == GetCandMasks( g4 ) );
+
+	Grid gAll( g );
+	CHECK( countCycles( SearchAllCycles( gAll, gAll.GetXCyclesCache(), 4, true ) ) > 1 );   // all the cycles, for batch mode
+}
+
+TEST_CASE( "test of x-cycles cache", "[xccache]" )
+{
+	Grid g;
+	g.buildFromString( "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79" );
+	g.initCandidates();
+	Algo_RemoveCandidates( g );
+	auto& cache = g.GetXCyclesCache();
+	CHECK( !cache.IsUpToDate( g, 1 ) );
+
+	auto nbCycles = 0;
+	auto count = [&]( const Cycle& ){ nbCycles++; return false; };
+	CHECK( !cache.VisitCycles( g, 1, count ) );
+	CHECK( cache.IsUpToDate( g, 1 ) );
+	CHECK( !cache.IsUpToDate( g, 2 ) );
+	auto nbFirst = nbCycles;
+	CHECK( !cache.VisitCycles( g, 1, count ) );      // taken from cache: same cycles
+	CHECK( nbCycles == 2*nbFirst );
+
+	Grid g2( g );
+	CHECK( !g2.GetXCyclesCache().IsUpToDate( g2, 1 ) );   // the copy has its own cache
+
+	index_t c = 0;
+	while( !g.getCell( c ).HasCandidate( 1 ) )
+		c++;
+	g.getCell( c ).RemoveCandidate( 2 );                 // other value: cache still valid
+	CHECK( cache.IsUpToDate( g, 1 ) );
+	g.getCell( c ).RemoveCandidate( 1 );                 // graph of value 1 must be rebuilt
+	CHECK( !cache.IsUpToDate( g, 1 ) );
+	CHECK( !cache.VisitCycles( g, 1, count ) );
+	CHECK( cache.IsUpToDate( g, 1 ) );
+}
+
+TEST_CASE( "test of grouped x-cycles eliminations", "[cycles3]" )
+{
+	auto getRemovedCells = []( const std::vector<Elimination>& v_elim )
+	{
+		std::vector<index_t> out;
+		for( const auto& e: v_elim )
+		{
+			CHECK( !e._keepOnly );
+			CHECK( e._val == 1 );
+			out.push_back( GetCellIndex( e._pos ) );
+		}
+		std::sort( out.begin(), out.end() );
+		return out;
+	};
+	CellSet board;
+	XcNode group( board.set( 0 ).set( 1 ) );           // A1-A2
+	XcNode a7( pos_t(0,6) ), b3( pos_t(1,2) ), e3( pos_t(4,2) ), e7( pos_t(4,6) );
+	{
+		INFO( "Rule 2: two strong links on the group, the value is in the group" )
+		Grid g;
+		g.buildFromString( std::string( 81, '.' ) );
+		for( index_t c: { 2, 9, 10, 18, 19, 20 } )         // 1 only in A1, A2, B3 in block 1
+			g.getCell( c ).RemoveCandidate( 1 );
+		for( index_t c: { 3, 4, 5, 7, 8 } )                // 1 only in A1, A2, A7 in row A
+			g.getCell( c ).RemoveCandidate( 1 );
+		for( index_t c: { 36, 37, 39, 40, 41, 43, 44 } )   // 1 only in E3, E7 in row E
+			g.getCell( c ).RemoveCandidate( 1 );
+		Cycle cy;
+		cy.AddElem( Link( b3, group, LT_Strong, OR_BLK ) );
+		cy.AddElem( Link( group, a7, LT_Strong, OR_ROW ) );
+		cy.AddElem( Link( a7, e7, LT_Weak, OR_COL ) );
+		cy.AddElem( Link( e7, e3, LT_Strong, OR_ROW ) );
+		cy.AddElem( Link( e3, b3, LT_Weak, OR_COL ) );
+		auto ct = GetCycleType( cy );
+		CHECK( ct._ctype == CT_Discont_2SL );
+		CHECK( ct._idx == 0 );
+		CHECK( getRemovedCells( ExploreCycle( cy, g, 1 ) ) == std::vector<index_t>( { 6, 11 } ) );   // A7, B3: they see the whole group
+	}
+	{
+		INFO( "Rule 3: two weak links on the group, the value is not in the group" )
+		Grid g;
+		g.buildFromString( std::string( 81, '.' ) );
+		for( index_t c: { 15, 24, 33, 51, 60, 69, 78 } )   // 1 only in A7, E7 in col 7
+			g.getCell( c ).RemoveCandidate( 1 );
+		for( index_t c: { 2, 20, 29, 47, 56, 65, 74 } )    // 1 only in B3, E3 in col 3
+			g.getCell( c ).RemoveCandidate( 1 );
+		Cycle cy;
+		cy.AddElem( Link( b3, group, LT_Weak, OR_BLK ) );
+		cy.AddElem( Link( group, a7, LT_Weak, OR_ROW ) );
+		cy.AddElem( Link( a7, e7, LT_Strong, OR_COL ) );
+		cy.AddElem( Link( e7, e3, LT_Weak, OR_ROW ) );
+		cy.AddElem( Link( e3, b3, LT_Strong, OR_COL ) );
+		auto ct = GetCycleType( cy );
+		CHECK( ct._ctype == CT_Discont_2WL );
+		CHECK( ct._idx == 0 );
+		CHECK( getRemovedCells( ExploreCycle( cy, g, 1 ) ) == std::vector<index_t>( { 0, 1 } ) );    // A1, A2
+	}
+}
+
+TEST_CASE( "test of pattern overlay", "[pom]" )
+{
+	const auto& templates = GetTemplates();
+	CHECK( templates.size() == NB_TEMPLATES );
+	CHECK( templates[0].count() == 9 );
+	CHECK( templates.back().count() == 9 );
+
+	CellSet placed;
+	CellSet board;
+	CellSet removals;
+	index_t where = 0;
+	board.set();
+	CHECK( PatternOverlayRemovals( placed, board, removals, where ) == CO_None );
+	CHECK( removals.none() );
+
+	for( index_t col=0; col<9; col++ )           // X-Wing: on rows A and D, the value is only in cols 1 and 5
+		if( col != 0 && col != 4 )
+		{
+			board.reset( col );
+			board.reset( 27+col );
+		}
+	CHECK( PatternOverlayRemovals( placed, board, removals, where ) == CO_None );
+	CHECK( removals.count() == 14 );
+	CHECK( removals[9] );                            // B1
+	CHECK( !removals[27] );                          // D1
+
+	board.reset();                                   // no template fits: nothing is removed
+	board.set( 0 );
+	CHECK( PatternOverlayRemovals( placed, board, removals, where ) == CO_MissingValue );
+	CHECK( removals.none() );
+	CHECK( where == 1 );                             // no place in row B
+
+	Grid g;
+	g.buildFromString( std::string( 81, '.' ) );
+	g.InitStatus();
+	for( index_t r=0; r<9; r+=3 )                    // rows A, D and G: 1 only in cols 1 and 2
+		for( index_t col=2; col<9; col++ )
+			g.getCell( r*9+col ).RemoveCandidate( 1 );
+	CHECK( g.GetStatus()._contradiction == CO_None );   // each unit still has a place for 1
+	auto before = GetCandMasks( g );
+	CHECK( !Algo_PatternOverlay( g ) );
+	CHECK( g.GetStatus()._contradiction == CO_MissingValue );
+	CHECK( g.GetStatus()._where == 6 );                 // row G, once A and D are placed
+	CHECK( GetRemovals( before, g ).empty() );
+}
+
+TEST_CASE( "test of singles propagation on snapshots", "[forcing]" )
+{
+	Grid g;
+	g.buildFromString( "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79" );
+	g.initCandidates();
+	auto s = TakeSnapshot( g );
+	CHECK( s._cands[0] == 0 );                       // A1 holds a value
+	CHECK( s._cands[2] == 0x1FF );                   // candidates not yet removed from the grid
+
+	auto s2( s );
+	CHECK( PropagateSingles( s2 ) );                 // that one can be solved with singles only
+	std::string sol;
+	for( index_t c=0; c<9; c++ )
+		sol += '0' + s2._values[c];
+	CHECK( sol == "534678912" );
+	CHECK( s._values[2] == 0 );                      // the copy did not touch the original
+
+	auto s3( s );
+	CHECK( !PlaceValue( s3, 2, 5 ) );               // 5 already in row A
+	s3 = s;
+	s3._values[2] = 3;                               // 3 already in row A
+	CHECK( !PropagateSingles( s3 ) );
+
+	Algo_RemoveCandidates( g );
+	CHECK( Algo_Forcing( g ) );
+	const std::string solution = "534678912672195348198342567859761423426853791713924856961537284287419635345286179";
+	for( index_t c=0; c<81; c++ )                    // the right value is never removed
+	{
+		const auto& cell = g.getCell( c );
+		value_t v = solution[c] - '0';
+		CHECK( ( cell.GetValue() == v || cell.HasCandidate( v ) ) );
+	}
+
+	Grid g2;
+	g2.buildFromString( std::string( 81, '.' ) );
+	g2.InitStatus();
+	for( index_t c=0; c<3; c++ )                     // A1, A2, A3 share two values: both trials of A1 fail
+		g2.getCell( c ).RemoveCandidates( 0x1FF & ~CandMask( {1,2} ) );
+	auto before = GetCandMasks( g2 );
+	CHECK( g2.GetStatus()._contradiction == CO_None );
+	CHECK( !Algo_Forcing( g2 ) );
+	CHECK( g2.GetStatus()._contradiction == CO_EmptyCell );
+	CHECK( g2.GetStatus()._where == 0 );
+	CHECK( GetRemovals( before, g2 ).empty() );
+}
+
+TEST_CASE( "test of contradiction flags", "[status]" )
+{
+	Grid g;
+	g.buildFromString( std::string( 81, '.' ) );
+	g.initCandidates();
+	g.InitStatus();
+	CHECK( g.GetStatus()._contradiction == CO_None );
+
+	Grid g2( g );
+	for( index_t c=0; c<9; c++ )                       // no place left for 5 in row A
+		g2.getCell( c ).RemoveCandidate( 5 );
+	CHECK( g2.GetStatus()._contradiction == CO_MissingValue );
+	CHECK( g2.GetStatus()._where == 0 );
+	CHECK( g.GetStatus()._contradiction == CO_None );    // the copy has its own status
+
+	g.getCell( 0 ).RemoveCandidates( 0x1FE );          // A1 = 1
+	CHECK( g.getCell( 0 ).GetValue() == 1 );
+	CHECK( g.GetStatus()._contradiction == CO_None );
+	g.getCell( 10 ).RemoveCandidates( 0x1FE );         // B2 = 1, same block
+	CHECK( g.GetStatus()._contradiction == CO_DuplicateValue );
+	CHECK( g.GetStatus()._where == 18 );
+
+	g = g2;
+	g.getCell( 40 ).RemoveCandidates( 0x1FE );
+	CHECK( g.GetStatus()._contradiction == CO_MissingValue );   // first contradiction is kept
+	CHECK( g2.getCell( 40 ).GetValue() == 0 );
+}
+
+TEST_CASE( "test of incremental checking", "[check]" )
+{
+	Grid g;
+	g.buildFromString( "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79" );
+	g.initCandidates();
+	g.InitStatus();
+	CHECK( g.CheckChanges() );
+	CHECK( g.GetStatus()._changed == 0 );
+
+	Algo_RemoveCandidates( g );
+	CHECK( g.GetStatus()._changed != 0 );
+	CHECK( g.CheckChanges() );
+	CHECK( g.GetStatus()._changed == 0 );
+
+	auto s = TakeSnapshot( g );
+	CHECK( CountSolutions( s, 2 ) == 1 );
+	CHECK( s._values[2] == 4 );
+	Grid empty;
+	empty.buildFromString( std::string( 81, '.' ) );
+	auto s2 = TakeSnapshot( empty );
+	CHECK( CountSolutions( s2, 2 ) == 2 );           // search stops at the second one
+
+	g.SetSolution( s._values );                       // oracle
+	g.getCell( 2 ).RemoveCandidate( 1 );              // fine, solution is 4
+	CHECK( g.GetStatus()._contradiction == CO_None );
+	Grid g4( g );
+	g4.getCell( 2 ).SetValue( 2 );
+	CHECK( g4.GetStatus()._contradiction == CO_WrongAssignment );
+	CHECK( g4.GetStatus()._where == 2 );
+	g.getCell( 2 ).RemoveCandidate( 4 );
+	CHECK( g.GetStatus()._contradiction == CO_WrongRemoval );
+	CHECK( g.GetStatus()._where == 2 );
+
+	empty.InitStatus();
+	CHECK( empty.CheckChanges() );
+	empty.getCell( 0 ).SetStatus( nullptr );         // A1 change not seen by the status
+	empty.getCell( 0 ).RemoveCandidate( 1 );
+	Grid g3( empty );                                 // the copy has its cells linked to its status
+	g3.getCell( 1 ).RemoveCandidate( 1 );             // row A, col 2, block 1 changed
+	CHECK( !g3.CheckChanges() );
+	CHECK( g3.GetStatus()._contradiction == CO_StaleStatus );
+	CHECK( g3.GetStatus()._where == 0 );              // row A
+}
+
+TEST_CASE( "test of next hint", "[hint]" )
+{
+	Grid g;
+	g.buildFromString( "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79" );
+	g.initCandidates();
+	auto before = g.getCell( 2 ).GetCandMask();
+
+	auto verbose  = g_data.Verbose;
+	auto logSteps = g_data.LogSteps;
+	auto nbSteps  = g_data.NbSteps;
+	g_data.Verbose  = true;
+	g_data.LogSteps = 3;
+	std::ostringstream oss;
+	auto buf = std::cout.rdbuf( oss.rdbuf() );
+	auto hint = g.FindHint();
+	std::cout.rdbuf( buf );
+	CHECK( oss.str().empty() );                                  // silent, whatever the options
+	CHECK( g_data.Verbose );                                     // that are left untouched
+	CHECK( g_data.LogSteps == 3 );
+	CHECK( g_data.NbSteps == nbSteps );
+	g_data.Verbose  = verbose;
+	g_data.LogSteps = logSteps;
+
+	REQUIRE( hint.Found() );
+	CHECK( hint._algo == ALG_REMOVE_CAND );
+	CHECK( hint._changes._removed.test( hint._changes._cell ) );
+	CHECK( hint._changes._because._bt == B_ValuePresent );
+	CHECK( hint._changes._nbSteps > 0 );
+	CHECK( g.getCell( 2 ).GetCandMask() == before );             // grid not changed
+
+	g.FindHint( true );
+	CHECK( g.getCell( 2 ).GetCandMask() != before );             // now it is
+	CHECK( g_data.NbSteps == nbSteps + hint._changes._nbSteps );  // and the steps are counted
+	CHECK( g.GetStatus()._record == nullptr );
+	{
+		QuietOutput q1;
+		{
+			QuietOutput q2;
+		}
+		CHECK( QuietOutput::IsOn() );                            // nested scopes restore the previous state
+	}
+	CHECK( !QuietOutput::IsOn() );
+
+	Grid g2;
+	g2.buildFromString( std::string( 81, '.' ) );
+	for( index_t c=1; c<9; c++ )                                 // A1 is the only place for 1 and 2 in row A
+		g2.getCell( c ).RemoveCandidates( CandMask( {1,2} ) );
+	before = g2.getCell( 0 ).GetCandMask();
+	hint = g2.FindHint( true );
+	CHECK( !hint.Found() );                                      // no hint on an invalid grid
+	CHECK( hint._contradiction == CO_TwoValues );
+	CHECK( hint._where == 0 );
+	CHECK( !hint._changes._any );
+	CHECK( g2.getCell( 0 ).GetCandMask() == before );            // and the grid is not changed
+
+	Hint last;
+	for( int i=0; i<100 && ( hint = g.FindHint( true ) ).Found(); i++ )
+		last = hint;
+	CHECK( !hint.Found() );
+	CHECK( !last._changes._placed.none() );
+	for( index_t c=0; c<81; c++ )                                // easy grid: solved by hints
+		CHECK( g.getCell( c ).GetValue() != 0 );
+}
@@ -30,6 +30,9 @@
 See:
 - http://www.sudokuwiki.org/X_Cycles
 - http://www.sudokuwiki.org/X_Cycles_Part_2
+- http://www.sudokuwiki.org/Grouped_X_Cycles
+
+The cycles are searched in a graph built with BGL, see FindCycles() and CycleGenerator.
 
 */
 
@@ -39,13 +42,20 @@ See:
 #else
 
 #include <fstream>
+#include <bitset>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 
-#include "udgcd.hpp"
+#include <boost/graph/adjacency_list.hpp>
 
 #include "grid.h"
 #include "header.h"
 #include "x_cycles.h"
 #include "algorithms.h"
+#include "alloc_count.h"
 
 
 #ifdef GENERATE_DOT_FILES
@@ -67,14 +77,42 @@ GetString( En_CycleType ct )
 	}
 }
 //----------------------------------------------------------------------------
-Cell&
-GetCommonCell( const Link& l1, const Link& l2, Grid& g )
+/// Returns the node (cell or group) that is shared by the two links
+XcNode
+GetCommonNode( const Link& l1, const Link& l2 )
 {
 	if( l1.p1 == l2.p2 || l1.p1 == l2.p1 )
-		return g.GetCellByPos( l1.p1 );
+		return l1.p1;
 	if( l1.p2 == l2.p1 || l1.p2 == l2.p2 )
-		return g.GetCellByPos( l1.p2 );
+		return l1.p2;
 	assert(0); // should never be here...
+	return l1.p1;
+}
+//----------------------------------------------------------------------------
+/// Removes the duplicate links of \c v_link (same two nodes, in any order), keeping the first one
+/**
+The node pairs already seen are flagged in a table indexed by XcNode::GetIndex(), so this is linear in the nb of links
+*/
+void
+RemoveDupeLinks( std::vector<Link>& v_link )
+{
+	std::array<std::bitset<XC_MAX_NODES>,XC_MAX_NODES> seen;
+	auto it = std::remove_if(
+		v_link.begin(),
+		v_link.end(),
+		[&]( const Link& l )
+		{
+			auto i1 = l.p1.GetIndex();
+			auto i2 = l.p2.GetIndex();
+			if( i1 > i2 )
+				std::swap( i1, i2 );
+			if( seen[i1][i2] )
+				return true;
+			seen[i1].set( i2 );
+			return false;
+		}
+	);
+	v_link.erase( it, v_link.end() );
 }
 //----------------------------------------------------------------------------
 /// Searches from position \c pos for all the weak links based on value \c val. Result is \b added to \c v_wl
@@ -131,10 +169,10 @@ FindAllWeakLinks( const Grid& g, value_t val, pos_t current_pos )
 	FindWeakLinks( g, val, current_pos, OR_BLK, v_wl );
 
 //	PrintVector( v_wl, "FindAllWeakLinks BEFORE dupes removal" );
-	auto v_wl2 = VectorRemoveDupes( v_wl );
+	RemoveDupeLinks( v_wl );
 
-//	PrintVector( v_wl2, "FindAllWeakLinks after dupes removal" );
-	return v_wl2;
+//	PrintVector( v_wl, "FindAllWeakLinks after dupes removal" );
+	return v_wl;
 }
 //----------------------------------------------------------------------------
 /// Finds in the grid \c g all the strong links for value \c val and orientation \c orient
@@ -145,7 +183,7 @@ FindStrongLinks( value_t val, EN_ORIENTATION orient, const Grid& g, std::vector<
 	{
 		PRINT_MAIN_IDX(orient);
 		View_1Dim_c v1d = g.GetView( orient, idx );
-		CandMap candMap;
+		CandSet candMap = CandSet::All();
 		for( index_t col1=0; col1<8; col1++ )   // for each cell in the view
 		{
 			const Cell& cell1 = v1d.GetCell(col1);
@@ -181,21 +219,72 @@ FindStrongLinks( value_t val, const Grid& g )
 	FindStrongLinks( val, OR_COL, g, v_link );
 	FindStrongLinks( val, OR_BLK, g, v_link );
 //	PrintVector( v_link, "strong links BEFORE REMOVE DUPES" );
-	auto v_link2 =  VectorRemoveDupes( v_link );
-//	PrintVector( v_link2, "strong links AFTER REMOVE DUPES" );
-	return v_link2;
+	RemoveDupeLinks( v_link );
+//	PrintVector( v_link, "strong links AFTER REMOVE DUPES" );
+	return v_link;
+}
+//----------------------------------------------------------------------------
+/// Finds the links involving at least one group node, for the value having \c board as candidate board (see Grid::GetCandidateBoard())
+/**
+A group is made of the (2 or 3) cells holding the value in a row/col - block intersection.
+Inside a row/col/block holding a group, the group is linked to each other node (single cell or other group) of that unit
+not sharing a cell with it: the link is strong if these two nodes hold all the candidates of the unit, weak otherwise.
+
+Strong links are \b added to \c v_sl, and weak links to \c v_wl.
+
+See http://www.sudokuwiki.org/Grouped_X_Cycles
+*/
+void
+FindGroupLinks( const CellSet& board, std::vector<Link>& v_sl, std::vector<Link>& v_wl )
+{
+	const auto& table = GetIntersectionsTable();
+	for( size_t k=0; k<table.size(); k++ )
+	{
+		auto group = board & table[k]._inter;
+		if( group.count() < 2 )
+			continue;
+
+		for( auto orient: { table[k]._orient, OR_BLK } )    // the two units holding the group
+		{
+			const auto& unit = ( orient == OR_BLK ? table[k]._block : table[k]._line );
+			auto unitCands = board & unit;
+
+			std::vector<CellSet> v_other;
+			for( auto c: unitCands & ~group )                // the single cells
+			{
+				CellSet single;
+				v_other.push_back( single.set( c ) );
+			}
+			for( size_t j=0; j<table.size(); j++ )           // the other groups inside that unit
+			{
+				auto other = board & table[j]._inter;
+				if( j != k && ( table[j]._inter & ~unit ).none() && other.count() > 1 && ( other & group ).none() )
+					v_other.push_back( other );
+			}
+
+			for( const auto& other: v_other )
+			{
+				if( ( group | other ) == unitCands )
+					v_sl.push_back( Link{ XcNode( group ), XcNode( other ), LT_Strong, orient } );
+				else
+					v_wl.push_back( Link{ XcNode( group ), XcNode( other ), LT_Weak, orient } );
+			}
+		}
+	}
+	RemoveDupeLinks( v_sl );
+	RemoveDupeLinks( v_wl );
 }
 //----------------------------------------------------------------------------
-/// Vertex datatype, with BGL. Holds a cell position
+/// Vertex datatype, with BGL. Holds a cell or a group of cells
 struct GraphNode
 {
-	pos_t pos;
+	XcNode node;
 };
 /// Edge datatype
 struct GraphEdge
 {
-	En_LinkType link_type;
-	EN_ORIENTATION link_orient;
+	En_LinkType    link_type   = LT_Weak;
+	EN_ORIENTATION link_orient = OR_ROW;
 };
 //-------------------------------------------------------------------
 /// A functor class used to printout the properties of the edges
@@ -263,25 +352,55 @@ typedef boost::adjacency_list<
 typedef typename boost::graph_traits<graph_t>::vertex_descriptor vertex_t;
 typedef typename boost::graph_traits<graph_t>::edge_descriptor   edge_t;
 
+static_assert( std::is_same<vertex_t,size_t>::value, "CycleGenerator needs vertex indexes" );
+
 //----------------------------------------------------------------------------
-/// Find vertex (get iterator on the vertex that we are searching), given its position \c pos
-int
-FindVertex( pos_t pos, const graph_t& g )
+/// Node to vertex index, maintained alongside the graph while building it in FindCycles()
+/**
+Avoids searching the whole set of vertices for each link endpoint (was quadratic),
+and holds an adjacency bitmask so that we can check in O(1) if two nodes are already linked.
+Both are indexed by node index, see XcNode::GetIndex()
+*/
+struct VertexMap
 {
-    auto it_pair = boost::vertices(g);
+	std::array<int,XC_MAX_NODES>                       _vertex;   ///< vertex of each node, -1 if node not in graph
+	std::array<std::bitset<XC_MAX_NODES>,XC_MAX_NODES> _adjacent; ///< for each node, the nodes it is linked to
 
-    auto it_v = std::find_if(
-		it_pair.first,           // begin
-		it_pair.second,          // end
-		[&g,pos]                             // lambda: what we are capturing from outside
-		(vertex_t v)                         // lambda: argument (the dereferenced iterator)
-		{ return (g[v].pos) == pos; }  // lambda: what we do here: return true if Id of current vertex is equal to what we are searching
-	);
+	VertexMap()
+	{
+		_vertex.fill( -1 );
+	}
 
-    if( it_v == it_pair.second )                    // if not found,
-		return -1;
-	return static_cast<int>(*it_v);
-}
+/// Returns the vertex of node \c node, adds it to the graph if not already present
+	vertex_t GetVertex( const XcNode& node, graph_t& graph )
+	{
+		auto& v = _vertex[ node.GetIndex() ];
+		if( v == -1 )
+		{
+			v = boost::add_vertex( graph );
+			graph[v].node = node;
+		}
+		return static_cast<vertex_t>( v );
+	}
+
+	bool IsLinked( const XcNode& n1, const XcNode& n2 ) const
+	{
+		return _adjacent[ n1.GetIndex() ][ n2.GetIndex() ];
+	}
+
+/// Adds an edge between the two nodes, does NOT check if already present, see IsLinked()
+	void AddEdge( const XcNode& n1, const XcNode& n2, En_LinkType lt, EN_ORIENTATION orient, graph_t& graph )
+	{
+		auto v1 = GetVertex( n1, graph );
+		auto v2 = GetVertex( n2, graph );
+		auto e = boost::add_edge( v1, v2, graph ).first;
+		graph[e].link_type   = lt;
+		graph[e].link_orient = orient;
+
+		_adjacent[ n1.GetIndex() ][ n2.GetIndex() ] = true;
+		_adjacent[ n2.GetIndex() ][ n1.GetIndex() ] = true;
+	}
+};
 //----------------------------------------------------------------------------
 void
 PrintGraphCycle( const std::vector<vertex_t>& cy, const graph_t& graph )
@@ -293,7 +412,7 @@ PrintGraphCycle( const std::vector<vertex_t>& cy, const graph_t& graph )
 		auto pair_edge = boost::edge( idx1, idx2, graph );
 		assert( pair_edge.second );
 
-		std::cout << '(' << graph[idx1].pos << ")-"
+		std::cout << '(' << graph[idx1].node << ")-"
 			<< GetString( graph[pair_edge.first].link_orient )
 			<< '/'
 			<< ( graph[pair_edge.first].link_type==LT_Strong ? 'S' : 'W' )
@@ -302,14 +421,6 @@ PrintGraphCycle( const std::vector<vertex_t>& cy, const graph_t& graph )
 	std::cout << '\n';
 }
 //----------------------------------------------------------------------------
-void
-PrintGraphCycles( std::vector<std::vector<vertex_t>> cycles, std::string msg, const graph_t& graph )
-{
-	std::cout << "Cycles: " << msg << " nb=" << cycles.size() << '\n';
-	for( const auto& cy: cycles )
-		PrintGraphCycle( cy, graph );
-}
-//----------------------------------------------------------------------------
 /// Returns true if the cycle \c cy has no more than 2 consecutive weak links
 bool
 CycleIsOk( const std::vector<vertex_t>& cy, const graph_t& graph )
@@ -365,15 +476,19 @@ CycleIsOk( const std::vector<vertex_t>& cy, const graph_t& graph )
 	return true;
 }
 //----------------------------------------------------------------------------
-/// Returns the vector without the cycles having more than 2 consecutive weak links
-std::vector<std::vector<vertex_t>>
-FilterCycles( const std::vector<std::vector<vertex_t>>& vv_in, const graph_t& graph )
+/// Returns true if the nodes of the cycle \c cy do not share any cell (some groups may overlap with other nodes)
+bool
+NodesAreDisjoint( const std::vector<vertex_t>& cy, const graph_t& graph )
 {
-	std::vector<std::vector<vertex_t>> vv_out;
-	for( const auto& c: vv_in )
-		if( CycleIsOk( c, graph ) )
-			vv_out.push_back( c );
-	return vv_out;
+	CellSet used;
+	for( auto v: cy )
+	{
+		auto board = graph[v].node.GetBoard();
+		if( ( used & board ).any() )
+			return false;
+		used |= board;
+	}
+	return true;
 }
 //----------------------------------------------------------------------------
 /// Converts the cycle from a BGL representation into a \c Cycle representation
@@ -389,8 +504,8 @@ Convert2Cycle( const std::vector<vertex_t>& in_cycle, const graph_t& graph )
 
 		out_cycle.AddElem(
 			Link(
-				graph[idx1].pos,
-				graph[idx2].pos,
+				graph[idx1].node,
+				graph[idx2].node,
 				graph[edge].link_type,
 				graph[edge].link_orient
 			)
@@ -399,57 +514,45 @@ Convert2Cycle( const std::vector<vertex_t>& in_cycle, const graph_t& graph )
 	return out_cycle;
 }
 //----------------------------------------------------------------------------
-/// Converts the cycles from the "graph" representation into a vector of \c Cycle
-std::vector<Cycle>
-Convert2Cycles( const std::vector<std::vector<vertex_t>>& v_cycle, const graph_t& graph )
+/// Returns the adjacency lists of the graph, sorted, as used by CycleGenerator
+std::vector<std::vector<size_t>>
+GetAdjacencyLists( const graph_t& graph )
 {
-	std::vector<Cycle> v_out;
-	for( const auto& cy: v_cycle )
-		v_out.push_back( Convert2Cycle( cy, graph ) );
-	return v_out;
+	auto nbv = boost::num_vertices( graph );
+	std::vector<std::vector<size_t>> adj( nbv );
+	for( vertex_t v=0; v<nbv; v++ )
+	{
+		auto pair_it = boost::adjacent_vertices( v, graph );
+		adj[v].assign( pair_it.first, pair_it.second );
+		std::sort( adj[v].begin(), adj[v].end() );
+	}
+	return adj;
 }
 //----------------------------------------------------------------------------
-/// Finds all the cycles in the grid for value \c val.
-/// Needs as input the set of Strong Links that have been found
+/// Builds in \c graph the graph of the links for value \c val: the strong links, then the weak links of each of their nodes. See FindCycles()
 /**
-This function relies on the udgcd library.
-
-If GENERATE_DOT_FILES is defined, this function will generate dot files for the graphs found.
+If GENERATE_DOT_FILES is defined, this function will generate dot files for the graphs built.
 You can plot them with <tt>make dot</tt>. Strong links will be bold, and weak links not.
 
 For each value, two graph dot files will be generated:
 - \c ls_V_X.dot: holds strong-links only graph, for value V
 - \c la_V_X.dot: holds graph completed with weak links
 */
-std::vector<Cycle>
-FindCycles(
-	const Grid&              g,
-	value_t                  val,
-	const std::vector<Link>& v_StrongLinks
+void
+BuildLinksGraph(
+	const Grid&                        g,
+	value_t                            val,
+	const std::vector<Link>&           v_StrongLinks,
+	const std::vector<Link>&           v_GroupWeakLinks,
+	graph_t&                           graph
 )
 {
-	COUT( " val=" << (int)val );
+	ALLOC_PHASE( AP_XC_GRAPH );
+
 // 1 - add all the strong links to the graph
-	graph_t graph;
+	VertexMap vmap;
 	for( const auto& sl: v_StrongLinks )
-	{
-		auto v1 = FindVertex( sl.p1, graph );
-		if( v1 == -1 )
-		{
-			v1 = boost::add_vertex( graph );
-			graph[v1].pos = sl.p1;
-		}
-		auto v2 = FindVertex( sl.p2, graph );
-		if( v2 == -1 )
-		{
-			v2 = boost::add_vertex( graph );
-			graph[v2].pos = sl.p2;
-		}
-
-        auto e = boost::add_edge( v1, v2, graph ).first;
-		graph[e].link_type   = LT_Strong;
-		graph[e].link_orient = sl._lorient;
-	}
+		vmap.AddEdge( sl.p1, sl.p2, LT_Strong, sl._lorient, graph );
 
 #ifdef GENERATE_DOT_FILES
 	static std::array<int,9> dot_counter;
@@ -458,7 +561,7 @@ FindCycles(
 	boost::write_graphviz(
 		file,
 		graph,
-		make_node_writer( boost::get( &GraphNode::pos, graph ) ),
+		make_node_writer( boost::get( &GraphNode::node, graph ) ),
 		make_edge_writer( boost::get( &GraphEdge::link_type, graph ), boost::get( &GraphEdge::link_orient, graph ) )
 	);
 #endif
@@ -468,28 +571,23 @@ FindCycles(
 	for( ; pair_node_it.first != pair_node_it.second; pair_node_it.first++ )
 	{
 		vertex_t src = *pair_node_it.first;
-		auto pos_src = graph[src].pos;
-		auto v_WeakLinks = FindAllWeakLinks( g, val, pos_src );
-//		std::cout << "Nb Weak links for pos " << pos_src << "=" << v_WeakLinks.size() << '\n';
+		auto node_src = graph[src].node;
+		std::vector<Link> v_WeakLinks;
+		if( !node_src.IsGroup() )
+			v_WeakLinks = FindAllWeakLinks( g, val, node_src.GetPos() );
+		for( const auto& wl: v_GroupWeakLinks )
+			if( wl.p1 == node_src || wl.p2 == node_src )
+				v_WeakLinks.push_back( wl );
+//		std::cout << "Nb Weak links for node " << node_src << "=" << v_WeakLinks.size() << '\n';
 //		PrintVector(v_WeakLinks, "weaklinks");
 		for( const auto& wl: v_WeakLinks )
 		{
-			auto pos_wl = wl.p1;        // consider the other side of the link,
-			if( pos_wl == pos_src )     // related to source position
-				pos_wl = wl.p2;
+			auto node_wl = wl.p1;        // consider the other side of the link,
+			if( node_wl == node_src )    // related to source node
+				node_wl = wl.p2;
 
-			auto v = FindVertex( pos_wl, graph );
-			if( v == -1 )
-			{
-				v = boost::add_vertex( graph );
-				graph[v].pos = pos_wl;
-			}
-			if( !boost::edge( src, v, graph ).second )                   // add the edge only if not already present
-			{
-				auto e = boost::add_edge( src, v, graph ).first;
-				graph[e].link_type   = LT_Weak;
-				graph[e].link_orient = wl._lorient;
-			}
+			if( !vmap.IsLinked( node_src, node_wl ) )                   // add the edge only if not already present
+				vmap.AddEdge( node_src, node_wl, LT_Weak, wl._lorient, graph );
 		}
 	}
 #ifdef GENERATE_DOT_FILES
@@ -498,27 +596,73 @@ FindCycles(
 	boost::write_graphviz(
 		file2,
 		graph,
-		make_node_writer( boost::get( &GraphNode::pos, graph ) ),
+		make_node_writer( boost::get( &GraphNode::node, graph ) ),
 		make_edge_writer( boost::get( &GraphEdge::link_type, graph ), boost::get( &GraphEdge::link_orient, graph ) )
 	);
 	dot_counter[val]++;
 #endif
+}
+//----------------------------------------------------------------------------
+/// Finds the cycles in the grid for value \c val, shortest first, and calls \c onCycle on each of them.
+/// Needs as input the set of Strong Links that have been found, and the Weak Links involving a group (see FindGroupLinks())
+/**
+The search stops as soon as \c onCycle returns true, and the function then returns true.
+It also stops when one of the budgets has been reached, see GlobData::xcMaxCycleLength, GlobData::xcMaxCycles
+and GlobData::xcMaxVisits.
+The cycles having more than 2 consecutive weak links, or having two nodes sharing a cell, are not considered.
+*/
+bool
+FindCycles(
+	const Grid&                        g,
+	value_t                            val,
+	const std::vector<Link>&           v_StrongLinks,
+	const std::vector<Link>&           v_GroupWeakLinks,
+	std::function<bool(const Cycle&)>  onCycle
+)
+{
+	COUT( " val=" << (int)val );
+// 1 - build the graph, see BuildLinksGraph()
+	graph_t graph;
+	BuildLinksGraph( g, val, v_StrongLinks, v_GroupWeakLinks, graph );
 
-	if( g_data.Verbose )
-		std::cout << "FindCycles(): start udgcd::findCycles()" << std::endl;
-	auto cycles = udgcd::findCycles<graph_t,vertex_t>( graph );
-//	std::cout << "VAL=" << (int)val << " nb cycles=" << cycles.size() << '\n';
-//	PrintCycles( cycles, "v1", graph );
-	if( g_data.Verbose )
-		std::cout << " => found " << cycles.size() << " cycles\n";
-
-	auto cycles2 = FilterCycles( cycles, graph );
-//	std::cout << "FindCycles(): after filtering: VAL=" << (int)val << " nb cycles2=" << cycles2.size() << '\n';
-
-	if( g_data.Verbose )
-		PrintGraphCycles( cycles2, "AFTER FILTERING", graph );
-
-	return Convert2Cycles( cycles2, graph );
+// 2 - search the cycles
+	CycleGenerator generator(
+		GetAdjacencyLists( graph ),
+		g_data.xcMaxCycleLength,
+		g_data.xcMaxCycles,
+		g_data.xcMaxVisits,
+		[&]( const std::vector<vertex_t>& cycle )           // only those count in the budget
+		{
+			return CycleIsOk( cycle, graph ) && NodesAreDisjoint( cycle, graph );
+		}
+	);
+	std::vector<vertex_t> cycle;
+	while( generator.Next( cycle ) )
+	{
+		if( IsVerbose() )
+			PrintGraphCycle( cycle, graph );
+		if( onCycle( Convert2Cycle( cycle, graph ) ) )
+			return true;
+	}
+	if( IsVerbose() )
+		std::cout << " => found " << generator.Count() << " cycles, " << generator.Visits() << " vertices visited\n";
+	return false;
+}
+//----------------------------------------------------------------------------
+/// Returns true if the links of the cycle can alternate, starting from link \c start with type \c lt
+/**
+A strong link can always be used as a weak one, but a weak link can not be used as a strong one
+*/
+bool
+CanAlternate( const Cycle& cy, size_t start, En_LinkType lt )
+{
+	for( size_t i=0; i<cy.size(); i++ )
+	{
+		if( lt == LT_Strong && cy.GetElem( start+i )._ltype == LT_Weak )
+			return false;
+		lt = ( lt == LT_Strong ? LT_Weak : LT_Strong );
+	}
+	return true;
 }
 //----------------------------------------------------------------------------
 /// Analyze the cycle and return as a pair its type and the index where the discontinuity occurs (if any, -1 if none)
@@ -527,8 +671,11 @@ Rules:
 - if even nb of links: is either continuous or invalid
 - if odd nb of links: is either CT_Discont_2SL, CT_Discont_2WL or invalid
 
-\todo needs a rewrite !
-We need to handle the case where a discontinuity occurs at the end !
+As strong links can be used as weak links, a cycle may have several interpretations.
+For odd cycles, we search for a position where two links of same type can be chained and the
+others alternate, considering the cycle as circular (the discontinuity may be between the last and the first link).
+The "2 strong links" case is preferred, as it enables assigning a value.
+The returned index \c idx is such that the discontinuity is on the cell shared by links \c idx and \c idx+1 (modulo size).
 
 Test cases:
 \verbatim
@@ -540,6 +687,7 @@ size  0 1 2 3 4 5
   7   W-S-W-S-W-S-S => discontinuous, 2 strong links
   7   S-W-S-W-S-W-S => discontinuous, 2 strong links
   7   S-S-W-S-W-S-W => discontinuous, 2 strong links
+  5   S-S-S-W-S     => discontinuous, 2 strong links, idx=1
 
   6   W-W-W-S-W-S => invalid: 3 weak links
   6   W-W-S-W-S-W => invalid: 3 weak links
@@ -551,91 +699,26 @@ size  0 1 2 3 4 5
 CycleType
 GetCycleType( const Cycle& cy )
 {
-	size_t count_WL = 0;   ///< Nb of Weak Links
-	size_t count_SL = 0;   ///< Nb of Strong Links
-	bool   has2WL(false);  ///< Has 2 Weak Links
-	bool   has2SL(false);  ///< Has 2 Strong Links
-	int    idx = -1;
-
-// first check if even and only strong links => then, is continuous
-	if( cy.size()%2 == 0 )     // if even
+	auto n = cy.size();
+	if( n%2 == 0 )     // if even, then it must alternate
 	{
-		if( std::find_if(
-				std::begin( cy.data() ),
-				std::end(   cy.data() ),
-				[](const Link& l){return l._ltype==LT_Weak; }
-			)
-			==
-			std::end(  cy.data() )
-		)
+		if( CanAlternate( cy, 0, LT_Strong ) || CanAlternate( cy, 0, LT_Weak ) )
 			return CycleType( CT_Continuous );
+		return CycleType( CT_Invalid );
 	}
 
-	for( size_t i=0; i<cy.size(); i++ )
-	{
-		const auto& bl = cy.GetElem(i);
-		if( bl._ltype == LT_Weak )
-		{
-			count_WL++;
-			count_SL = 0;
-		}
-		else
-		{
-			count_WL = 0;
-			count_SL++;
-		}
-
-		if( count_WL == 2 )
-		{
-			if( has2WL ) // if had previously counted 2
-			{
-				return CycleType( CT_Invalid );
-			}
-			else
-			{
-				has2WL = true;
-				idx = i-1;
-			}
-		}
+	for( size_t k=0; k<n; k++ )   // discontinuity on cell shared by links k and k+1, both strong
+		if( cy.GetElem( k )._ltype == LT_Strong && CanAlternate( cy, k+1, LT_Strong ) )
+			return CycleType( CT_Discont_2SL, static_cast<int>(k) );
 
-		if( count_SL == 2 )
-		{
-			if( has2SL ) // if had previously counted 2
-				return CycleType( CT_Invalid );
-			else
-			{
-				has2SL = true;
-				idx = i-1;
-			}
-		}
+	for( size_t k=0; k<n; k++ )   // discontinuity on cell shared by links k and k+1, both weak
+		if( CanAlternate( cy, k+1, LT_Weak ) )
+			return CycleType( CT_Discont_2WL, static_cast<int>(k) );
 
-		if( count_WL == 3 )
-		{
-			return CycleType( CT_Invalid );
-		}
-	}
-
-	En_CycleType cyctype = CT_undefined;
-	{
-		if( has2WL )                         // if has 2 weak links
-		{
-			if( has2SL || cy.size()%2 == 0 ) // AND also 2 strong links or is even
-				cyctype = CT_Invalid;
-			else
-				cyctype = CT_Discont_2WL;
-		}
-		else
-		{
-			if( has2SL )
-				cyctype = CT_Discont_2SL;
-			else
-				cyctype = CT_Continuous;
-		}
-	}
-	return CycleType( cyctype, idx );
+	return CycleType( CT_Invalid );
 }
 //----------------------------------------------------------------------------
-/// Explore a cycle and do the corresponding action, that is either:
+/// Explore a cycle and return the corresponding eliminations, that is either:
 /**
 - Nice Loops Rule 1
 - Nice Loops Rule 2
@@ -643,18 +726,20 @@ GetCycleType( const Cycle& cy )
 
 See http://www.sudokuwiki.org/X_Cycles for details
 
-Returns true if some removals have been processed
+With a group node (see FindGroupLinks()), Rule 2 removes the value from the cells that see the whole group,
+and Rule 3 from all the cells of the group.
+
+The grid is not modified, see ApplyEliminations()
 */
-bool
-ExploreCycle( Cycle& cy, Grid& g, value_t val )
+std::vector<Elimination>
+ExploreCycle( const Cycle& cy, const Grid& g, value_t val )
 {
 	COUT( __FUNCTION__ << "(): " << cy );
-	bool removalDone( false );
+	std::vector<Elimination> v_elim;
 	auto gct = GetCycleType( cy );
 	assert( gct._ctype != CT_undefined );
 	COUT( "Cycle type=" << GetString( gct._ctype ) << " idx=" << gct._idx );
 
-	assert( gct._ctype != CT_undefined );
 	switch( gct._ctype )
 	{
 		case CT_Continuous:                          // then, do the "Nice Loops Rule 1"
@@ -664,21 +749,23 @@ ExploreCycle( Cycle& cy, Grid& g, value_t val )
 				const auto& link = cy.GetElem( i );
 				COUT( "link: " << link );
 
-				View_1Dim_nc view;       // step 1 - get the corresponding view (row/col/block)
+				auto pos1 = link.p1.GetPos();
+				View_1Dim_c view;        // step 1 - get the corresponding view (row/col/block)
 				switch( link._lorient )
 				{
-					case OR_ROW: view = g.GetView( link._lorient, link.p1.first ); break;
-					case OR_COL: view = g.GetView( link._lorient, link.p1.second ); break;
-					case OR_BLK: view = g.GetView( link._lorient, GetBlockIndex( link.p1 ) ); break;
+					case OR_ROW: view = g.GetView( link._lorient, pos1.first ); break;
+					case OR_COL: view = g.GetView( link._lorient, pos1.second ); break;
+					case OR_BLK: view = g.GetView( link._lorient, GetBlockIndex( pos1 ) ); break;
 					default: assert(0);
 				}
 
+				auto linkCells = link.p1.GetBoard() | link.p2.GetBoard();
 				for( index_t i=0; i<9; i++ ) // step 2 - parse the view and remove from the cells the value
-				{                            //          (except for the two cells part of the link)
-					auto& cell = view.GetCell( i );
-					if( cell.GetPos() != link.p1 && cell.GetPos() != link.p2 )
-						if( cell.RemoveCandidate( val ) )
-							removalDone = true;
+				{                            //          (except for the cells part of the link)
+					const auto& cell = view.GetCell( i );
+					if( !linkCells[ GetCellIndex( cell.GetPos() ) ] )
+						if( cell.HasCandidate( val ) )
+							v_elim.push_back( Elimination( cell.GetPos(), val ) );
 				}
 			}
 		break;
@@ -686,12 +773,26 @@ ExploreCycle( Cycle& cy, Grid& g, value_t val )
 		case CT_Discont_2SL: // Nice Loops Rule 2
 		{
 			COUT( "* Nice Loops Rule 2" );
-			ASSERT_1( gct._idx != 0, gct._idx );
+			assert( gct._idx >= 0 );          // 0 is valid: the two strong links are the first ones
 			const auto& link1 = cy.GetElem( gct._idx);
 			const auto& link2 = cy.GetElem( gct._idx+1 );
-			Cell& c = GetCommonCell( link1, link2, g );
-			if( c.RemoveAllCandidatesBut( val ) )
-				removalDone = true;
+			auto node = GetCommonNode( link1, link2 );
+			if( !node.IsGroup() )
+			{
+				if( g.GetCellByPos( node.GetPos() ).NbCandidates() > 1 )
+					v_elim.push_back( Elimination( node.GetPos(), val, true ) );
+			}
+			else                                 // the value is in the group: remove it from the cells that see the whole group
+			{
+				CellSet seen;
+				seen.set();
+				auto board = node.GetBoard();
+				for( auto c: board )
+					seen &= GetPeerMasks()[c];
+				seen &= g.GetCandidateBoard( val );
+				for( auto c: seen )
+					v_elim.push_back( Elimination( GetPosFromCellIndex( c ), val ) );
+			}
 		}
 		break;
 
@@ -701,10 +802,12 @@ ExploreCycle( Cycle& cy, Grid& g, value_t val )
 			const auto& link2 = cy.GetElem( gct._idx+1 );
 			COUT( "* Nice Loops Rule 3: link1=" << link1 << " link2=" << link2 );
 
-			Cell& c = GetCommonCell( link1, link2, g );
-			COUT( "Common cell=" << c );
-			if( c.RemoveCandidate( val ) )
-				removalDone = true;
+			auto node = GetCommonNode( link1, link2 );
+			COUT( "Common node=" << node );
+			auto board = node.GetBoard();               // the value can not be in any cell of the node
+			for( auto c: board )
+				if( g.getCell( c ).HasCandidate( val ) )
+					v_elim.push_back( Elimination( GetPosFromCellIndex( c ), val ) );
 		}
 		break;
 
@@ -713,15 +816,365 @@ ExploreCycle( Cycle& cy, Grid& g, value_t val )
 
 		default: assert(0);
 	}
+	return v_elim;
+}
+//----------------------------------------------------------------------------
+/// Returns true if applying the eliminations \c v_elim would remove some candidate, the grid is not modified. See ApplyEliminations()
+bool
+EliminationsRemoveSome( const std::vector<Elimination>& v_elim, const Grid& g )
+{
+	for( const auto& elim: v_elim )
+	{
+		const Cell& c = g.GetCellByPos( elim._pos );
+		if( elim._keepOnly )
+		{
+			if( c.GetCandMask() & ~( 1 << (elim._val-1) ) )    // see Cell::RemoveAllCandidatesBut()
+				return true;
+		}
+		else
+			if( c.HasCandidate( elim._val ) )
+				return true;
+	}
+	return false;
+}
+//----------------------------------------------------------------------------
+/// Applies to the grid the eliminations found by ExploreCycle(). Returns true if some removals have been processed
+bool
+ApplyEliminations( const std::vector<Elimination>& v_elim, Grid& g )
+{
+	bool removalDone( false );
+	for( const auto& elim: v_elim )
+	{
+		Cell& c = g.GetCellByPos( elim._pos );
+		if( elim._keepOnly )
+		{
+			if( c.RemoveAllCandidatesBut( elim._val ) )
+				removalDone = true;
+		}
+		else
+		{
+			if( c.RemoveCandidate( elim._val ) )
+				removalDone = true;
+		}
+	}
 	return removalDone;
 }
 //----------------------------------------------------------------------------
+/// Searches the cycles for value \c val, or takes them from the cache, and calls \c onCycle on each of them.
+/**
+The search stops as soon as \c onCycle returns true, and the function then returns true.
+The cycles are stored in the cache only if the search went through.
+*/
+bool
+XCyclesCache::VisitCycles( const Grid& g, value_t val, std::function<bool(const Cycle&)> onCycle )
+{
+	auto& entry = _entries[val-1];
+	auto candBoard = g.GetCandidateBoard( val );
+	if( entry._valid && entry._candBoard == candBoard )
+	{
+		COUT( "X_Cycles: value " << (int)val << ", using cached cycles" );
+		for( const auto& cy: entry._cycles )
+			if( onCycle( cy ) )
+				return true;
+		return false;
+	}
+
+	entry._valid = false;
+	entry._cycles.clear();
+	auto v_sl = FindStrongLinks( val, g );
+	std::vector<Link> v_gwl;
+	FindGroupLinks( candBoard, v_sl, v_gwl );
+	if( IsVerbose() )
+	{
+		std::cout << "\nX_Cycles: process value " << (int)val << '\n';
+		PrintVector( v_sl, "Strong Links set" );
+	}
+	if( v_sl.size() > 1 )
+	{
+		auto stopped = FindCycles(
+			g,
+			val,
+			v_sl,
+			v_gwl,
+			[&]( const Cycle& cy )
+			{
+				entry._cycles.push_back( cy );
+				return onCycle( cy );
+			}
+		);
+		if( stopped )
+			return true;
+	}
+	entry._candBoard = candBoard;
+	entry._valid = true;
+	return false;
+}
+//----------------------------------------------------------------------------
+/// Returns true if the cycles of value \c val are cached and still valid for grid \c g
+bool
+XCyclesCache::IsUpToDate( const Grid& g, value_t val ) const
+{
+	const auto& entry = _entries[val-1];
+	return entry._valid && entry._candBoard == g.GetCandidateBoard( val );
+}
+//----------------------------------------------------------------------------
+/// Returns the X-cycles cache of the grid, created on first use
+XCyclesCache&
+Grid::GetXCyclesCache()
+{
+	if( !_xcCache )
+		_xcCache.reset( new XCyclesCache );
+	return *_xcCache;
+}
+
+//----------------------------------------------------------------------------
+/// Threads kept waiting between two searches, so that they are not created on each call of X_Cycles(). See SearchAllCycles()
+/**
+Run() executes a task on the calling thread and on some of the pool threads, and returns when all are done.
+Only one grid can use the pool at a time: if it is busy, the calling thread runs the task alone.
+*/
+class WorkerPool
+{
+	public:
+		WorkerPool() = default;
+		WorkerPool( const WorkerPool& ) = delete;
+		WorkerPool& operator = ( const WorkerPool& ) = delete;
+		~WorkerPool();
+		void Run( int nbThreads, const std::function<void()>& task );
+
+	private:
+		void Loop( size_t idx );
+
+		std::mutex _runMtx;                 ///< held during a Run()
+		std::mutex _mtx;                    ///< protects the fields below
+		std::condition_variable _cvStart;
+		std::condition_variable _cvDone;
+		std::vector<std::thread> _threads;
+		const std::function<void()>* _task = nullptr;
+		size_t _generation = 0;             ///< incremented on each Run(), wakes up the threads
+		size_t _nbHelpers  = 0;             ///< nb of pool threads working on the current task
+		size_t _running    = 0;             ///< nb of them that have not finished yet
+		bool   _stop       = false;
+};
+//----------------------------------------------------------------------------
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( _mtx );
+		_stop = true;
+	}
+	_cvStart.notify_all();
+	for( auto& t: _threads )
+		t.join();
+}
+//----------------------------------------------------------------------------
+/// Runs \c task on \c nbThreads threads, the calling one included
+void
+WorkerPool::Run( int nbThreads, const std::function<void()>& task )
+{
+	std::unique_lock<std::mutex> runLock( _runMtx, std::try_to_lock );
+	if( !runLock.owns_lock() || nbThreads < 2 )
+	{
+		task();
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock( _mtx );
+		_nbHelpers = nbThreads-1;
+		while( _threads.size() < _nbHelpers )
+			_threads.emplace_back( &WorkerPool::Loop, this, _threads.size() );
+		_task    = &task;
+		_running = _nbHelpers;
+		++_generation;
+	}
+	_cvStart.notify_all();
+	task();                                   // calling thread works too
+
+	std::unique_lock<std::mutex> lock( _mtx );
+	_cvDone.wait( lock, [this]{ return _running == 0; } );
+	_task = nullptr;
+}
+//----------------------------------------------------------------------------
+/// Thread function: waits for a task, runs it if this thread is needed, and waits again
+void
+WorkerPool::Loop( size_t idx )
+{
+	size_t seen = 0;
+	std::unique_lock<std::mutex> lock( _mtx );
+	for(;;)
+	{
+		_cvStart.wait( lock, [&]{ return _stop || _generation != seen; } );
+		if( _stop )
+			return;
+		seen = _generation;
+		if( idx >= _nbHelpers )
+			continue;
+		auto task = _task;
+		lock.unlock();
+		(*task)();
+		lock.lock();
+		if( --_running == 0 )
+			_cvDone.notify_one();
+	}
+}
+//----------------------------------------------------------------------------
+/// Searches the cycles of all the values, and the corresponding eliminations, without modifying the grid. See X_Cycles()
+/**
+If \c nbThreads > 1, the values are processed concurrently (see WorkerPool): they are independent until the eliminations are applied,
+so each worker thread takes the next value to process, searches its cycles and the corresponding eliminations.
+
+If \c all is false, only the first cycle that enables some removal is needed, and only for the lowest value having one
+(see ApplyFirstEliminations()). So the search of a value stops at its first such cycle, and a value is skipped
+(or its search stopped) as soon as a lower one has found one. The result is the same as with the sequential search.
+*/
+XCyclesResults
+SearchAllCycles( const Grid& g, XCyclesCache& cache, int nbThreads, bool all )
+{
+	static WorkerPool pool;
+	XCyclesResults out;
+	std::atomic<int> nextValue( 1 );
+	std::atomic<int> firstFound( 10 );          // lowest value having a cycle that enables some removal
+
+	auto worker = [&]()
+	{
+		ALLOC_PHASE( ALG_X_CYCLES );
+		int v;
+		while( (v = nextValue++) < 10 && ( all || v < firstFound ) )
+		{
+			cache.VisitCycles(                     // each thread only touches the cache entry of its value
+				g,
+				v,
+				[&]( const Cycle& cy )
+				{
+					if( !all && v > firstFound )       // a lower value will be used
+						return true;
+					auto v_elim = ExploreCycle( cy, g, v );
+					if( all )
+					{
+						out[v-1].push_back( std::move( v_elim ) );
+						return false;
+					}
+					if( !EliminationsRemoveSome( v_elim, g ) )
+						return false;
+					out[v-1].push_back( std::move( v_elim ) );
+					int cur = firstFound;
+					while( v < cur && !firstFound.compare_exchange_weak( cur, v ) )
+						;
+					return true;
+				}
+			);
+		}
+	};
+	pool.Run( std::min( nbThreads, 9 ), worker );
+	return out;
+}
+//----------------------------------------------------------------------------
+/// Returns false if the set of eliminations is not consistent, see X_Cycles() in batch mode
+/**
+Inconsistent means that once applied, along with the removal of the kept values from the peer cells, we would have:
+- a cell that must hold two different values, or a value that has been removed,
+- two cells of the same row/col/block that must hold the same value,
+- a cell without any candidate left,
+- a row/col/block without any place left for some value.
+*/
+bool
+EliminationsAreConsistent( const std::vector<Elimination>& v_elim, const Grid& g )
+{
+	std::array<CandSet,81> cands;                     // what each cell may hold once the eliminations are applied
+	for( index_t i=0; i<81; i++ )
+	{
+		const Cell& cell = g.getCell( i );
+		if( cell.GetValue() != 0 )
+			cands[i] = CandSet( 1 << ( cell.GetValue()-1 ) );
+		else
+			cands[i] = cell.GetCandidates();
+	}
+
+	std::array<value_t,81> keptValue;                 // value that must be in each cell, 0 if none
+	keptValue.fill( 0 );
+	for( const auto& elim: v_elim )
+	{
+		auto idx = GetCellIndex( elim._pos );
+		if( elim._keepOnly )
+		{
+			if( keptValue[idx] != 0 && keptValue[idx] != elim._val )
+				return false;
+			keptValue[idx] = elim._val;
+		}
+		else
+			cands[idx].Remove( elim._val );
+	}
+
+	for( index_t i=0; i<81; i++ )
+	{
+		auto val = keptValue[i];
+		if( val != 0 )
+		{
+			if( !cands[i].Has( val ) )
+				return false;
+			cands[i] = CandSet( 1 << ( val-1 ) );
+			for( auto j: GetPeerMasks()[i] )        // the value can not be in the peer cells
+				cands[j].Remove( val );
+		}
+	}
+
+	for( index_t i=0; i<81; i++ )
+		if( cands[i].Empty() )                        // also catches peers that must hold the same value
+			return false;
+
+	for( const auto& unit: GetUnitsTable() )
+	{
+		CandSet places;
+		for( auto i: unit )
+			places |= cands[i];
+		if( places != CandSet::All() )                // some value has no place left in the unit
+			return false;
+	}
+	return true;
+}
+//----------------------------------------------------------------------------
+/// Applies the eliminations of the first cycle that enables some removal, values and cycles taken in order
+bool
+ApplyFirstEliminations( const XCyclesResults& v_res, Grid& g )
+{
+	for( const auto& v_elimByCycle: v_res )     // values are in increasing order
+		for( const auto& v_elim: v_elimByCycle )
+			if( ApplyEliminations( v_elim, g ) )
+				return true;
+	return false;
+}
+//----------------------------------------------------------------------------
+/// Applies all the eliminations found if they are consistent, else only those of the first cycle. See X_Cycles() in batch mode
+bool
+ApplyBatchEliminations( const XCyclesResults& v_res, Grid& g )
+{
+	std::vector<Elimination> v_all;
+	for( const auto& v_elimByCycle: v_res )
+		for( const auto& v_elim: v_elimByCycle )
+			v_all.insert( v_all.end(), v_elim.begin(), v_elim.end() );
+	COUT( "X_Cycles: batch mode, " << v_all.size() << " eliminations found" );
+
+	if( EliminationsAreConsistent( v_all, g ) )
+		return ApplyEliminations( v_all, g );
+
+	COUT( "X_Cycles: batch mode, eliminations are not consistent, applying first one only" );
+	return ApplyFirstEliminations( v_res, g );
+}
+//----------------------------------------------------------------------------
 /// X Cycles algorithm (WIP)
 /**
 This enables removing some candidates
 
 See http://www.sudokuwiki.org/X_Cycles
 
+By default, we return as soon as a cycle enabled some removal. Two options change this:
+- \c -j (see GlobData::nbThreads): the values are processed concurrently,
+but the eliminations are applied afterwards on the calling thread, in the same order as when sequential.
+This is disabled when verbose, to avoid mixing outputs.
+- \c -b (see GlobData::xcyclesBatch): the eliminations of all the valid cycles of all the values are
+collected in one pass, checked for consistency, and applied together. If they are not consistent,
+we fall back to applying only the first cycle that enables some removal.
+
 \todo we only explore the first strong link! But other cycles could be found by iterating over the other ones
 
 */
@@ -729,27 +1182,30 @@ bool
 X_Cycles( Grid& g )
 {
 	PRINT_ALGO_START_2;
+	auto& cache = g.GetXCyclesCache();
+
+	int nbThreads = ( g_data.Verbose ? 1 : g_data.nbThreads );
+	if( nbThreads > 1 || g_data.xcyclesBatch )
+	{
+		auto v_res = SearchAllCycles( g, cache, nbThreads, g_data.xcyclesBatch );
+		if( !g_data.xcyclesBatch )
+			return ApplyFirstEliminations( v_res, g );
+		return ApplyBatchEliminations( v_res, g );
+	}
+
 	for( value_t v=1; v<10; v++ )             // for each possible value, get strong links, then search cycles
 	{
 		COUT( "* base value: " << (int)v );
-		auto v_sl = FindStrongLinks( v, g );
-		if( g_data.Verbose )
-		{
-			std::cout << "\nX_Cycles: process value " << (int)v << '\n';
-			PrintVector( v_sl, "Strong Links set" );
-		}
-//		const auto& sl_vect = msl.GetSLvect(v);
-//		std::cout << "considering value " << (int)v << ", vector has " << sl_vect.size() << " values\n";
-		if( v_sl.size() > 1 )
-		{
-			auto v_cyc = FindCycles( g, v, v_sl );
-//			std::cout << "VALUE=" << (int)v << " cycles:\n";
-			if( g_data.Verbose )
-				PrintVector( v_cyc, "v_cyc" );
-			for( auto& cy: v_cyc )       // not const, because cycles will get tagged
-				if( ExploreCycle( cy, g, v ) )
-					return true;
-		}
+		auto stopped = cache.VisitCycles(        // stop at first cycle enabling some removal
+			g,
+			v,
+			[&]( const Cycle& cy )
+			{
+				return ApplyEliminations( ExploreCycle( cy, g, v ), g );
+			}
+		);
+		if( stopped )
+			return true;
 	}
 
 	return false;
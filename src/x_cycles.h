@@ -33,6 +33,8 @@
 
 #include "circvec.h"
 
+#include <functional>
+
 //----------------------------------------------------------------------------
 /// Related to Cycle
 enum En_CycleType
@@ -60,11 +62,92 @@ enum En_LinkType
 	LT_Strong, LT_Weak
 };
 //----------------------------------------------------------------------------
-/// A link between two cells, also holds the second cell position.
+/// Nb of different nodes: the 81 single cells, and one group per row/col - block intersection (see GetIntersectionsTable())
+const size_t XC_MAX_NODES = 81 + 54;
+
+//----------------------------------------------------------------------------
+/// A node of a cycle: either a single cell, or a group of 2 or 3 cells sharing a block and a row/col (Grouped X-Cycles)
+/**
+Stored as the block index and a 9-bit mask of the cells inside that block, see getPosFromBlockIndex()
+*/
+struct XcNode
+{
+	index_t  _block = 0;
+	uint16_t _cells = 0;
+
+	XcNode()
+	{}
+	XcNode( pos_t pos ): _block( GetBlockIndex( pos ) ), _cells( 1 << ( pos.first%3*3 + pos.second%3 ) )
+	{}
+/// Builds the node from the 81-bit mask of its cells, that must all be in the same block
+	explicit XcNode( const CellSet& board )
+	{
+		for( auto c: board )
+			{
+				auto pos = GetPosFromCellIndex( c );
+				if( _cells == 0 )
+					_block = GetBlockIndex( pos );
+				assert( _block == GetBlockIndex( pos ) );
+				_cells |= 1 << ( pos.first%3*3 + pos.second%3 );
+			}
+	}
+	bool IsGroup() const
+	{
+		return ( _cells & (_cells-1) ) != 0;
+	}
+/// Returns the position of the first cell of the node (last cell of the block if the node is empty)
+	pos_t GetPos() const
+	{
+		index_t i = 0;
+		while( i<8 && !( _cells & (1<<i) ) )
+			i++;
+		return getPosFromBlockIndex( _block, i );
+	}
+/// Returns the cells of the node, as a 81-bit mask indexed by GetCellIndex()
+	CellSet GetBoard() const
+	{
+		CellSet out;
+		for( index_t i=0; i<9; i++ )
+			if( _cells & (1<<i) )
+				out.set( GetCellIndex( getPosFromBlockIndex( _block, i ) ) );
+		return out;
+	}
+/// Returns a unique index in [0-XC_MAX_NODES[: the cell index for single cells, 81 + intersection index for groups
+	size_t GetIndex() const
+	{
+		auto pos = GetPos();
+		if( !IsGroup() )
+			return GetCellIndex( pos );
+		if( ( _cells & ~( 7 << ( pos.first%3*3 ) ) ) == 0 )    // all cells on the same row
+			return 81 + pos.first*3 + pos.second/3;
+		return 81 + 27 + pos.second*3 + pos.first/3;
+	}
+	friend bool operator == ( const XcNode& n1, const XcNode& n2 )
+	{
+		return n1._block == n2._block && n1._cells == n2._cells;
+	}
+	friend bool operator != ( const XcNode& n1, const XcNode& n2 )
+	{
+		return !( n1 == n2 );
+	}
+	friend std::ostream& operator << ( std::ostream& s, const XcNode& n )
+	{
+		if( !n.IsGroup() )
+			return s << n.GetPos();
+		s << '[';
+		for( index_t i=0, k=0; i<9; i++ )
+			if( n._cells & (1<<i) )
+				s << ( k++ ? "," : "" ) << getPosFromBlockIndex( n._block, i );
+		return s << ']';
+	}
+};
+
+//----------------------------------------------------------------------------
+/// A link between two nodes (cells or groups of cells), also holds the second node.
 /// A link may be "Strong" (S) or "Weak (W"), and has an orientation, either Row, Col, or Block
 struct Link
 {
-	pos_t p1, p2;
+	XcNode p1, p2;
 	En_LinkType    _ltype;
 	EN_ORIENTATION _lorient = OR_ROW;
 
@@ -76,7 +159,7 @@ struct Link
 			return true;
 		return false;
 	}
-	Link( pos_t pA, pos_t pB, En_LinkType lt, EN_ORIENTATION o ): p1(pA), p2(pB), _ltype(lt), _lorient(o)
+	Link( XcNode pA, XcNode pB, En_LinkType lt, EN_ORIENTATION o ): p1(pA), p2(pB), _ltype(lt), _lorient(o)
 	{}
 //#ifdef TESTMODE
 	Link( En_LinkType lt ): _ltype(lt)
@@ -104,8 +187,164 @@ struct Cycle: public CircVec<Link>
 	}
 };
 //----------------------------------------------------------------------------
+/// A candidate removal found when exploring a cycle, see ExploreCycle() and ApplyEliminations()
+struct Elimination
+{
+	pos_t   _pos;
+	value_t _val;
+	bool    _keepOnly = false;  ///< if true, all the candidates but \c _val are removed from the cell (Nice Loops Rule 2)
+
+	Elimination( pos_t pos, value_t val, bool keepOnly=false ): _pos(pos), _val(val), _keepOnly(keepOnly)
+	{}
+	friend std::ostream& operator << ( std::ostream& s, const Elimination& e )
+	{
+		s << e._pos << (e._keepOnly ? '=' : '-') << (int)e._val;
+		return s;
+	}
+};
+//----------------------------------------------------------------------------
+/// Lazy generator of the (simple) cycles of a graph, shortest first. See FindCycles()
+/**
+Each call to Next() resumes the search where it was left, so that the caller can stop
+as soon as it found what it needs.
+
+Three budgets bound the cost of the search:
+- the maximum length of a cycle (nb of vertices),
+- the maximum number of cycles produced: only the cycles accepted by the optional \c accept function count,
+- the maximum number of vertices visited (the work), as paths that never close are not counted otherwise.
+
+For each length, cycles are searched with a depth-first search starting from each vertex,
+only considering vertices with a greater index than the starting one, and only one of the two
+orientations is kept, so that each cycle is produced once.
+*/
+class CycleGenerator
+{
+	public:
+		using Path = std::vector<size_t>;
+
+		CycleGenerator(
+			std::vector<std::vector<size_t>> adj,           ///< sorted adjacency lists
+			size_t maxLength,
+			size_t maxCount,
+			size_t maxVisits,
+			std::function<bool(const Path&)> accept = nullptr
+		)
+			: _adj( std::move(adj) ), _maxLength( maxLength ), _maxCount( maxCount ), _maxVisits( maxVisits ), _accept( accept )
+		{
+			_onPath.resize( _adj.size(), false );
+			_path.reserve( maxLength );
+			_next.reserve( maxLength );
+		}
+
+/// Fetches the next cycle in \c cycle. Returns false if no more cycles, or if a budget has been reached
+		bool Next( Path& cycle )
+		{
+			while( _length <= _maxLength && _count < _maxCount && _visits < _maxVisits )
+			{
+				if( _path.empty() )
+				{
+					if( _start >= _adj.size() )   // all starting vertices done for that length, switch to next length
+					{
+						_length++;
+						_start = 0;
+						continue;
+					}
+					Push( _start );
+				}
+				auto current = _path.back();
+				auto& next = _next.back();
+				if( next < _adj[current].size() )
+				{
+					auto v = _adj[current][next++];
+					if( _path.size() == _length )                            // we can only close the cycle
+					{
+						if( v == _start && _path[1] < _path.back() )      // keep only one orientation
+							if( !_accept || _accept( _path ) )
+							{
+								cycle = _path;
+								_count++;
+								return true;
+							}
+					}
+					else
+						if( v > _start && !_onPath[v] )
+							Push( v );
+				}
+				else                                 // all the neighbours have been explored: backtrack
+				{
+					_onPath[current] = false;
+					_path.pop_back();
+					_next.pop_back();
+					if( _path.empty() )
+						_start++;
+				}
+			}
+			return false;
+		}
+		size_t Count()  const { return _count; }
+		size_t Visits() const { return _visits; }
+
+	private:
+		void Push( size_t v )
+		{
+			_path.push_back( v );
+			_next.push_back( 0 );
+			_onPath[v] = true;
+			_visits++;
+		}
+
+	private:
+		std::vector<std::vector<size_t>> _adj;     ///< adjacency lists
+		size_t _maxLength;
+		size_t _maxCount;
+		size_t _maxVisits;
+		std::function<bool(const Path&)> _accept;
+		size_t _length = 3;                        ///< length of the cycles currently searched
+		size_t _count  = 0;                        ///< nb of accepted cycles produced so far
+		size_t _visits = 0;                        ///< nb of vertices pushed on the path so far
+		size_t _start  = 0;                        ///< starting vertex (lowest index of the cycle)
+		Path                  _path;               ///< current path
+		std::vector<size_t>   _next;               ///< for each vertex of the path, index of next neighbour to explore
+		std::vector<bool>     _onPath;
+};
+//----------------------------------------------------------------------------
+/// Eliminations found for each value (index 0 for value 1), and for each value, by cycle
+using XCyclesResults = std::array<std::vector<std::vector<Elimination>>,9>;
+
+//----------------------------------------------------------------------------
+/// Per-value cache of the X-cycles links graph results, see X_Cycles(). Owned by the Grid, see Grid::GetXCyclesCache()
+/**
+The links graph of a value (and thus the cycles) only depends on the set of cells holding that value as candidate.
+So for each value we keep that set along with the cycles found, and the graph is rebuilt
+only if a candidate of that value has been removed since last call.
+
+As the key is the candidate set itself, the cache stays valid whatever the grid it is used with.
+*/
+struct XCyclesCache
+{
+	/// Cached data for a given value
+	struct Entry
+	{
+		bool               _valid = false;
+		CellSet            _candBoard;  ///< cells holding the value as candidate when cycles were computed
+		std::vector<Cycle> _cycles;
+	};
+
+	bool VisitCycles( const Grid& g, value_t val, std::function<bool(const Cycle&)> onCycle );
+	bool IsUpToDate( const Grid& g, value_t val ) const;
+
+	private:
+		std::array<Entry,9> _entries;
+};
+//----------------------------------------------------------------------------
 
 bool X_Cycles( Grid& g );
 CycleType GetCycleType( const Cycle& cy );
+void FindGroupLinks( const CellSet& board, std::vector<Link>& v_sl, std::vector<Link>& v_wl );
+std::vector<Elimination> ExploreCycle( const Cycle& cy, const Grid& g, value_t val );
+bool EliminationsAreConsistent( const std::vector<Elimination>& v_elim, const Grid& g );
+bool ApplyFirstEliminations( const XCyclesResults& v_res, Grid& g );
+bool ApplyBatchEliminations( const XCyclesResults& v_res, Grid& g );
+XCyclesResults SearchAllCycles( const Grid& g, XCyclesCache& cache, int nbThreads, bool all );
 
 #endif